@@ -0,0 +1,432 @@
+/**
+ * @file        compare_bench.cpp
+ * @brief       Comparison of radix_trie with standard containers.
+ *
+ * @details     Runs the same workloads (insert, find hits and misses, prefix
+ *              completion) through Radix_Trie, Span_Trie at every span,
+ *              std::set, std::unordered_set and a sorted std::vector with
+ *              binary search, and prints throughput, latency percentiles and
+ *              memory per key as JSON.
+ *
+ *              Usage: radix-trie-compare [--sizes=N,N,...]
+ *                                        [--datasets=NAME,NAME,...]
+ *                                        [--seed=N]
+ *
+ *              Latencies are timed per operation, so they include the cost
+ *              of reading the clock (tens of ns). Memory is the growth of
+ *              live heap bytes, as reported by malloc_usable_size(), while
+ *              the container is built, so it includes allocator rounding.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#include "datasets.hpp"
+#include "radix_trie.hpp"
+#include "span_trie.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <new>
+#include <ranges>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <malloc.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifndef RADIX_TRIE_VERSION
+#define RADIX_TRIE_VERSION "unknown"
+#endif
+
+namespace {
+
+/**
+ * @brief Live heap bytes allocated through operator new.
+ */
+size_t live_bytes = 0;
+
+} // namespace
+
+// Not inlined, so GCC does not pair the malloc() and free() inside with
+// new and delete expressions and warn about a mismatch.
+[[gnu::noinline]] void *operator new(size_t size) {
+  void *ptr = std::malloc(size ? size : 1);
+  if (!ptr)
+    throw std::bad_alloc();
+  live_bytes += malloc_usable_size(ptr);
+  return ptr;
+}
+
+[[gnu::noinline]] void operator delete(void *ptr) noexcept {
+  if (ptr)
+    live_bytes -= malloc_usable_size(ptr);
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept { operator delete(ptr); }
+
+namespace {
+
+using namespace radix_trie;
+
+/**
+ * @brief Radix_Trie behind the common interface of the containers.
+ */
+struct Trie_Adapter {
+  static constexpr std::string_view name = "radix_trie";
+  Radix_Trie trie;
+
+  void insert(const std::string &key) { trie.insert(key); }
+  void finish() {}
+  bool contains(const std::string &key) const { return trie.contains(key); }
+  void complete(const std::string &pref, std::vector<std::string> &out) {
+    trie.complete(pref, out);
+  }
+};
+
+/**
+ * @brief Span_Trie with digits of a given number of bits.
+ */
+template <unsigned Span> struct Span_Trie_Adapter {
+  static constexpr std::string_view name = Span == 1   ? "span_trie<1>"
+                                           : Span == 2 ? "span_trie<2>"
+                                           : Span == 4 ? "span_trie<4>"
+                                                       : "span_trie<8>";
+  Span_Trie<Span> trie;
+
+  void insert(const std::string &key) { trie.insert(key); }
+  void finish() {}
+  bool contains(const std::string &key) const { return trie.contains(key); }
+  void complete(const std::string &pref, std::vector<std::string> &out) {
+    trie.complete(pref, out);
+  }
+};
+
+/**
+ * @brief std::set; completion walks the range starting at the prefix.
+ */
+struct Set_Adapter {
+  static constexpr std::string_view name = "std::set";
+  std::set<std::string> set;
+
+  void insert(const std::string &key) { set.insert(key); }
+  void finish() {}
+  bool contains(const std::string &key) const { return set.contains(key); }
+  void complete(const std::string &pref, std::vector<std::string> &out) {
+    for (auto it = set.lower_bound(pref);
+         it != set.end() && it->starts_with(pref); ++it)
+      if (it->size() > pref.size())
+        out.emplace_back(it->substr(pref.size()));
+  }
+};
+
+/**
+ * @brief std::unordered_set; completion has to scan every key.
+ */
+struct Unordered_Set_Adapter {
+  static constexpr std::string_view name = "std::unordered_set";
+  std::unordered_set<std::string> set;
+
+  void insert(const std::string &key) { set.insert(key); }
+  void finish() {}
+  bool contains(const std::string &key) const { return set.contains(key); }
+  void complete(const std::string &pref, std::vector<std::string> &out) {
+    for (const auto &key : set)
+      if (key.size() > pref.size() && key.starts_with(pref))
+        out.emplace_back(key.substr(pref.size()));
+  }
+};
+
+/**
+ * @brief Sorted std::vector with binary search. Inserts append, and
+ * finish() sorts and removes duplicates, as a bulk load.
+ */
+struct Sorted_Vector_Adapter {
+  static constexpr std::string_view name = "sorted_vector";
+  std::vector<std::string> vec;
+
+  void insert(const std::string &key) { vec.push_back(key); }
+  void finish() {
+    std::ranges::sort(vec);
+    auto dups = std::ranges::unique(vec);
+    vec.erase(dups.begin(), dups.end());
+  }
+  bool contains(const std::string &key) const {
+    return std::ranges::binary_search(vec, key);
+  }
+  void complete(const std::string &pref, std::vector<std::string> &out) {
+    for (auto it = std::ranges::lower_bound(vec, pref);
+         it != vec.end() && it->starts_with(pref); ++it)
+      if (it->size() > pref.size())
+        out.emplace_back(it->substr(pref.size()));
+  }
+};
+
+/**
+ * @brief Prevents the compiler from discarding a benchmark result.
+ */
+volatile size_t sink;
+
+/**
+ * @brief Per-operation latencies of one workload.
+ */
+struct Timings {
+  std::vector<double> ns;
+  double total_ns = 0;
+
+  /**
+   * @brief Returns empty timings with room for n operations.
+   */
+  static Timings with_capacity(size_t n) {
+    Timings t;
+    t.ns.reserve(n);
+    return t;
+  }
+
+  /**
+   * @brief Times fn(i) for every i in [0, n). Does not allocate if there is
+   * room for n operations, so the heap of the measured code is not skewed.
+   */
+  template <typename F> void run(size_t n, F &&fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; i++) {
+      auto op_start = std::chrono::steady_clock::now();
+      fn(i);
+      auto op_end = std::chrono::steady_clock::now();
+      ns.push_back(
+          std::chrono::duration<double, std::nano>(op_end - op_start).count());
+    }
+    auto end = std::chrono::steady_clock::now();
+    total_ns += std::chrono::duration<double, std::nano>(end - start).count();
+    std::ranges::sort(ns);
+  }
+
+  /**
+   * @brief Times fn(i) for every i in [0, n).
+   */
+  template <typename F> static Timings measure(size_t n, F &&fn) {
+    Timings t = with_capacity(n);
+    t.run(n, std::forward<F>(fn));
+    return t;
+  }
+
+  /**
+   * @brief Returns a latency percentile, by the nearest-rank method.
+   */
+  double percentile(double p) const {
+    if (ns.empty())
+      return 0;
+    auto rank = static_cast<size_t>(p / 100 * static_cast<double>(ns.size()));
+    return ns[std::min(rank, ns.size() - 1)];
+  }
+};
+
+/**
+ * @brief Inputs of one case, shared by every container.
+ */
+struct Workload {
+  std::string_view dataset;
+  size_t size;
+  std::vector<std::string> keys;
+  std::vector<std::string> lookups;
+  std::vector<std::string> misses;
+  std::vector<std::string> prefixes;
+};
+
+/**
+ * @brief Completions that scan every key run on at most this many prefixes,
+ * so large cases finish in reasonable time.
+ */
+constexpr size_t max_scan_prefixes = 20;
+
+/**
+ * @brief Runs every workload through one container and prints one JSON
+ * object per operation.
+ *
+ * @param work      The inputs.
+ * @param first     Whether these are the first results printed.
+ */
+template <typename Adapter> void run_container(const Workload &work,
+                                               bool &first) {
+  Adapter container;
+  double bytes_per_key = 0;
+
+  auto report = [&](std::string_view op, const Timings &t) {
+    double ops = static_cast<double>(t.ns.size());
+    std::cout << std::format(
+        "{}    {{\"dataset\": \"{}\", \"size\": {}, \"container\": \"{}\", "
+        "\"op\": \"{}\", \"ops\": {}, \"ops_per_sec\": {:.0f}, "
+        "\"p50_ns\": {:.0f}, \"p90_ns\": {:.0f}, \"p99_ns\": {:.0f}, "
+        "\"p999_ns\": {:.0f}, \"bytes_per_key\": {:.1f}}}",
+        first ? "" : ",\n", work.dataset, work.size, Adapter::name, op,
+        t.ns.size(), ops * 1e9 / std::max(t.total_ns, 1.0), t.percentile(50),
+        t.percentile(90), t.percentile(99), t.percentile(99.9),
+        bytes_per_key);
+    first = false;
+  };
+
+  // The timings are allocated before the snapshot, so bytes_per_key only
+  // counts the container.
+  Timings insert = Timings::with_capacity(work.keys.size());
+  size_t before = live_bytes;
+  insert.run(work.keys.size(),
+             [&](size_t i) { container.insert(work.keys[i]); });
+  auto start = std::chrono::steady_clock::now();
+  container.finish();
+  insert.total_ns += std::chrono::duration<double, std::nano>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+  bytes_per_key = static_cast<double>(live_bytes - before) /
+                  static_cast<double>(std::max<size_t>(work.keys.size(), 1));
+  report("insert", insert);
+
+  size_t found = 0;
+  report("find_hit", Timings::measure(work.lookups.size(), [&](size_t i) {
+           found += container.contains(work.lookups[i]);
+         }));
+  report("find_miss", Timings::measure(work.misses.size(), [&](size_t i) {
+           found += container.contains(work.misses[i]);
+         }));
+  sink = found;
+
+  size_t n_prefixes = work.prefixes.size();
+  if constexpr (std::is_same_v<Adapter, Unordered_Set_Adapter>)
+    n_prefixes = std::min(n_prefixes, max_scan_prefixes);
+  std::vector<std::string> out;
+  size_t completed = 0;
+  report("complete", Timings::measure(n_prefixes, [&](size_t i) {
+           out.clear();
+           container.complete(work.prefixes[i], out);
+           completed += out.size();
+         }));
+  sink = completed;
+  std::cout.flush();
+}
+
+/**
+ * @brief Runs every container on one key set.
+ *
+ * @param dataset   The key generator.
+ * @param n         Number of keys.
+ * @param seed      Seed of the key generator.
+ * @param first     Whether these are the first results printed.
+ */
+void run_case(const datasets::Dataset &dataset, size_t n, uint64_t seed,
+              bool first) {
+  Workload work{dataset.name, n, dataset.generate(n, seed), {}, {}, {}};
+  work.lookups = work.keys;
+  datasets::Rng rng(seed + 1);
+  for (size_t i = work.lookups.size(); i > 1; i--)
+    std::swap(work.lookups[i - 1], work.lookups[rng.below(i)]);
+
+  work.misses = work.lookups;
+  for (auto &key : work.misses)
+    key += '\x01';
+
+  for (size_t i = 0; i < std::min<size_t>(n, 1000); i++)
+    work.prefixes.push_back(
+        work.lookups[i].substr(0, work.lookups[i].size() * 3 / 4));
+
+  run_container<Trie_Adapter>(work, first);
+  run_container<Span_Trie_Adapter<1>>(work, first);
+  run_container<Span_Trie_Adapter<2>>(work, first);
+  run_container<Span_Trie_Adapter<4>>(work, first);
+  run_container<Span_Trie_Adapter<8>>(work, first);
+  run_container<Set_Adapter>(work, first);
+  run_container<Unordered_Set_Adapter>(work, first);
+  run_container<Sorted_Vector_Adapter>(work, first);
+}
+
+/**
+ * @brief Splits a comma-separated list.
+ */
+std::vector<std::string> split(std::string_view list) {
+  std::vector<std::string> items;
+  for (auto part : list | std::views::split(','))
+    if (!part.empty())
+      items.emplace_back(part.begin(), part.end());
+  return items;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::vector<size_t> sizes = {1'000, 10'000, 100'000, 1'000'000};
+  std::vector<std::string> names = {"urls", "file_paths", "uuids",
+                                    "zipf_words", "binary_ids"};
+  uint64_t seed = 42;
+
+  try {
+    for (int i = 1; i < argc; i++) {
+      std::string_view arg = argv[i];
+      if (arg.starts_with("--sizes=")) {
+        sizes.clear();
+        for (const auto &item : split(arg.substr(8)))
+          sizes.push_back(static_cast<size_t>(std::stod(item)));
+      } else if (arg.starts_with("--datasets=")) {
+        names = split(arg.substr(11));
+      } else if (arg.starts_with("--seed=")) {
+        seed = std::stoull(std::string(arg.substr(7)));
+      } else {
+        throw std::invalid_argument(std::format(
+            "Invalid argument \"{}\". Valid arguments are --sizes=N,..., "
+            "--datasets=NAME,..., --seed=N.",
+            arg));
+      }
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+
+  std::cout << std::format("{{\n  \"benchmark\": \"radix-trie-compare\",\n"
+                           "  \"version\": \"{}\",\n  \"seed\": {},\n"
+                           "  \"results\": [\n",
+                           RADIX_TRIE_VERSION, seed);
+  std::cout.flush();
+
+  // Every case runs in its own process, so the heap of one case does not
+  // fragment the next.
+  bool first = true;
+  for (const auto &name : names) {
+    auto dataset = std::ranges::find(datasets::all, name,
+                                     &datasets::Dataset::name);
+    if (dataset == datasets::all.end()) {
+      std::cerr << std::format("Unknown dataset \"{}\".\n", name);
+      return 1;
+    }
+
+    for (size_t n : sizes) {
+      pid_t pid = fork();
+      if (pid == 0) {
+        run_case(*dataset, n, seed, first);
+        _exit(0);
+      }
+
+      int status = 0;
+      if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) ||
+          WEXITSTATUS(status) != 0) {
+        std::cerr << std::format("Comparison {} with {} keys failed.\n", name,
+                                 n);
+        return 1;
+      }
+      first = false;
+    }
+  }
+
+  std::cout << "\n  ]\n}\n";
+  return 0;
+}
@@ -0,0 +1,344 @@
+/**
+ * @file        datasets.hpp
+ * @brief       Deterministic synthetic key sets for benchmarks and tests.
+ *
+ * @details     Generates realistic keys (URLs, file paths, IP addresses,
+ *              UUIDs, Zipf-distributed words, long shared-prefix keys) of any
+ *              size from a seed. The generators use their own PRNG and
+ *              integer range reduction, so the same seed yields the same keys
+ *              with every compiler and standard library.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace radix_trie::datasets {
+
+/**
+ * @brief SplitMix64 pseudo-random generator.
+ */
+class Rng {
+public:
+  explicit Rng(uint64_t seed) : _state(seed) {}
+
+  /**
+   * @brief Returns the next 64 random bits.
+   */
+  uint64_t next() {
+    uint64_t z = (_state += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+  }
+
+  /**
+   * @brief Returns a value in [0, bound), as the high half of the 128-bit
+   * product of 64 random bits and the bound.
+   */
+  uint64_t below(uint64_t bound) {
+    uint64_t x = next();
+    uint64_t x_lo = x & 0xffffffff, x_hi = x >> 32;
+    uint64_t b_lo = bound & 0xffffffff, b_hi = bound >> 32;
+    uint64_t mid = (x_lo * b_lo >> 32) + (x_hi * b_lo & 0xffffffff) +
+                   x_lo * b_hi;
+    return x_hi * b_hi + (x_hi * b_lo >> 32) + (mid >> 32);
+  }
+
+  /**
+   * @brief Returns a value in [lo, hi].
+   */
+  uint64_t between(uint64_t lo, uint64_t hi) { return lo + below(hi - lo + 1); }
+
+  /**
+   * @brief Returns a uniformly chosen element.
+   */
+  template <typename T, size_t N> const T &pick(const std::array<T, N> &arr) {
+    return arr[below(N)];
+  }
+
+  /**
+   * @brief Returns a value in [0, 1).
+   */
+  double unit() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+private:
+  uint64_t _state;
+};
+
+/**
+ * @brief Common English words, used for URL paths and file names.
+ */
+inline constexpr std::array<std::string_view, 64> common_words = {
+    "about",   "account", "admin",   "api",     "archive", "article",
+    "assets",  "blog",    "build",   "cache",   "cart",    "category",
+    "config",  "content", "data",    "debug",   "docs",    "download",
+    "events",  "export",  "feed",    "files",   "help",    "home",
+    "images",  "import",  "index",   "items",   "jobs",    "lib",
+    "login",   "logs",    "media",   "news",    "orders",  "page",
+    "photos",  "posts",   "private", "products", "profile", "public",
+    "reports", "search",  "server",  "settings", "shop",   "src",
+    "static",  "store",   "support", "tags",    "team",    "temp",
+    "test",    "tools",   "update",  "upload",  "users",   "util",
+    "v1",      "v2",      "video",   "view"};
+
+/**
+ * @brief Random lowercase keys of 8 to 24 characters.
+ */
+inline std::vector<std::string> random_keys(size_t n, uint64_t seed = 0) {
+  Rng rng(seed);
+  std::vector<std::string> keys(n);
+  for (auto &key : keys) {
+    key.resize(rng.between(8, 24));
+    for (char &c : key)
+      c = static_cast<char>('a' + rng.below(26));
+  }
+  return keys;
+}
+
+/**
+ * @brief Zero-padded decimal counters with a random stride, densely sharing
+ * prefixes.
+ */
+inline std::vector<std::string> sequential_keys(size_t n, uint64_t seed = 0) {
+  Rng rng(seed);
+  std::vector<std::string> keys(n);
+  uint64_t val = rng.below(1000);
+  for (auto &key : keys) {
+    val += rng.between(1, 8);
+    key = std::format("{:012}", val);
+  }
+  return keys;
+}
+
+/**
+ * @brief URLs over a few hundred hosts, with word paths, numeric ids and
+ * occasional query strings.
+ */
+inline std::vector<std::string> urls(size_t n, uint64_t seed = 0) {
+  static constexpr std::array<std::string_view, 6> tlds = {
+      "com", "org", "net", "io", "de", "co.uk"};
+  static constexpr std::array<std::string_view, 4> subdomains = {
+      "www.", "", "api.", "cdn."};
+
+  Rng rng(seed);
+  std::vector<std::string> hosts(std::max<size_t>(n / 1000, 16));
+  for (auto &host : hosts)
+    host = std::format("{}{}{}.{}", rng.pick(subdomains),
+                       rng.pick(common_words), rng.below(1000),
+                       rng.pick(tlds));
+
+  std::vector<std::string> keys(n);
+  for (auto &key : keys) {
+    key = std::format("https://{}", hosts[rng.below(hosts.size())]);
+    for (uint64_t depth = rng.between(1, 4); depth > 0; depth--)
+      key += std::format("/{}", rng.pick(common_words));
+    if (rng.below(2))
+      key += std::format("/{}", rng.below(1'000'000));
+    if (rng.below(4) == 0)
+      key += std::format("?page={}&sort={}", rng.below(100),
+                         rng.pick(common_words));
+  }
+  return keys;
+}
+
+/**
+ * @brief Hierarchical file paths: users, projects, nested directories and
+ * file names with extensions.
+ */
+inline std::vector<std::string> file_paths(size_t n, uint64_t seed = 0) {
+  static constexpr std::array<std::string_view, 8> extensions = {
+      "cpp", "hpp", "txt", "md", "json", "py", "png", "log"};
+
+  Rng rng(seed);
+  std::vector<std::string> keys(n);
+  for (auto &key : keys) {
+    key = std::format("/home/user{}/projects/{}{}", rng.below(32),
+                      rng.pick(common_words), rng.below(64));
+    for (uint64_t depth = rng.between(1, 5); depth > 0; depth--)
+      key += std::format("/{}", rng.pick(common_words));
+    key += std::format("/{}_{}.{}", rng.pick(common_words), rng.below(10'000),
+                       rng.pick(extensions));
+  }
+  return keys;
+}
+
+/**
+ * @brief Dotted IPv4 addresses, clustered in a few hundred /16 networks.
+ */
+inline std::vector<std::string> ipv4(size_t n, uint64_t seed = 0) {
+  Rng rng(seed);
+  std::vector<uint32_t> networks(256);
+  for (auto &network : networks)
+    network = static_cast<uint32_t>(rng.below(1 << 16)) << 16;
+
+  std::vector<std::string> keys(n);
+  for (auto &key : keys) {
+    uint32_t addr = networks[rng.below(networks.size())] |
+                    static_cast<uint32_t>(rng.below(1 << 16));
+    key = std::format("{}.{}.{}.{}", addr >> 24, (addr >> 16) & 0xff,
+                      (addr >> 8) & 0xff, addr & 0xff);
+  }
+  return keys;
+}
+
+/**
+ * @brief Lowercase IPv6 addresses in full form without leading zeros,
+ * clustered in a few hundred /48 networks.
+ */
+inline std::vector<std::string> ipv6(size_t n, uint64_t seed = 0) {
+  Rng rng(seed);
+  std::vector<std::string> networks(256);
+  for (auto &network : networks)
+    network = std::format("2001:{:x}:{:x}", rng.below(1 << 16),
+                          rng.below(1 << 16));
+
+  std::vector<std::string> keys(n);
+  for (auto &key : keys) {
+    key = networks[rng.below(networks.size())];
+    for (int group = 0; group < 5; group++)
+      key += std::format(":{:x}", rng.below(1 << 16));
+  }
+  return keys;
+}
+
+/**
+ * @brief Version 4 UUIDs in canonical lowercase form.
+ */
+inline std::vector<std::string> uuids(size_t n, uint64_t seed = 0) {
+  Rng rng(seed);
+  std::vector<std::string> keys(n);
+  for (auto &key : keys) {
+    uint64_t hi = rng.next();
+    uint64_t lo = rng.next();
+    hi = (hi & ~uint64_t{0xf000}) | 0x4000;
+    lo = (lo & ~(uint64_t{0xc} << 60)) | (uint64_t{0x8} << 60);
+    key = std::format("{:08x}-{:04x}-{:04x}-{:04x}-{:012x}", hi >> 32,
+                      (hi >> 16) & 0xffff, hi & 0xffff, lo >> 48,
+                      lo & 0xffffffffffff);
+  }
+  return keys;
+}
+
+/**
+ * @brief English-like words drawn from a synthetic vocabulary with a Zipf
+ * (s = 1) rank distribution, so a few words are very frequent and most are
+ * rare. Words are built from common syllables and suffixes.
+ */
+inline std::vector<std::string> zipf_words(size_t n, uint64_t seed = 0) {
+  static constexpr std::array<std::string_view, 24> syllables = {
+      "re", "in", "con", "de", "pro", "com", "ex", "dis", "un", "per", "ter",
+      "al", "an", "ment", "ver", "sta", "tra", "mo", "lo", "ca", "ri", "na",
+      "ple", "for"};
+  static constexpr std::array<std::string_view, 10> suffixes = {
+      "", "", "s", "ed", "ing", "ation", "er", "ly", "ness", "able"};
+
+  Rng rng(seed);
+  std::vector<std::string> vocab(std::max<size_t>(n / 4, 64));
+  for (auto &word : vocab) {
+    for (uint64_t parts = rng.between(1, 4); parts > 0; parts--)
+      word += rng.pick(syllables);
+    word += rng.pick(suffixes);
+  }
+
+  std::vector<double> cdf(vocab.size());
+  double total = 0;
+  for (size_t rank = 0; rank < vocab.size(); rank++)
+    cdf[rank] = total += 1.0 / static_cast<double>(rank + 1);
+
+  std::vector<std::string> keys(n);
+  for (auto &key : keys) {
+    auto it = std::ranges::upper_bound(cdf, rng.unit() * total);
+    key = vocab[std::min<size_t>(it - cdf.begin(), vocab.size() - 1)];
+  }
+  return keys;
+}
+
+/**
+ * @brief Fixed-length 16-byte binary ids with uniformly random bytes, like
+ * hashes or raw UUIDs.
+ */
+inline std::vector<std::string> binary_ids(size_t n, uint64_t seed = 0) {
+  Rng rng(seed);
+  std::vector<std::string> keys(n);
+  for (auto &key : keys) {
+    key.resize(16);
+    for (size_t half = 0; half < 16; half += 8) {
+      uint64_t bits = rng.next();
+      for (size_t i = 0; i < 8; i++)
+        key[half + i] = static_cast<char>(bits >> (8 * i));
+    }
+  }
+  return keys;
+}
+
+/**
+ * @brief Keys behind one of 16 long (about 64-byte) shared prefixes, like
+ * tenant-scoped record ids.
+ */
+inline std::vector<std::string> shared_prefix(size_t n, uint64_t seed = 0) {
+  Rng rng(seed);
+  std::vector<std::string> keys = random_keys(n, seed + 1);
+  for (auto &key : keys)
+    key = std::format("tenant-{:02}/region-eu-central/records/2026/10/"
+                      "partition-0001/",
+                      rng.below(16)) +
+          key;
+  return keys;
+}
+
+/**
+ * @brief A named generator.
+ */
+struct Dataset {
+  std::string_view name;
+  std::vector<std::string> (*generate)(size_t, uint64_t);
+};
+
+/**
+ * @brief Every available generator.
+ */
+inline constexpr std::array<Dataset, 10> all = {{
+    {"random", random_keys},
+    {"sequential", sequential_keys},
+    {"urls", urls},
+    {"file_paths", file_paths},
+    {"ipv4", ipv4},
+    {"ipv6", ipv6},
+    {"uuids", uuids},
+    {"zipf_words", zipf_words},
+    {"shared_prefix", shared_prefix},
+    {"binary_ids", binary_ids},
+}};
+
+/**
+ * @brief Generates a dataset by name.
+ *
+ * @param name      Name of the generator, see all.
+ * @param n         Number of keys.
+ * @param seed      Seed of the generator. Default is 0.
+ * @return          The keys, possibly with duplicates.
+ * @throws          std::invalid_argument if there is no such generator.
+ */
+inline std::vector<std::string> generate(std::string_view name, size_t n,
+                                         uint64_t seed = 0) {
+  auto it = std::ranges::find(all, name, &Dataset::name);
+  if (it == all.end())
+    throw std::invalid_argument(
+        std::format("Invalid dataset \"{}\".", name));
+  return it->generate(n, seed);
+}
+
+} // namespace radix_trie::datasets
@@ -0,0 +1,262 @@
+/**
+ * @file        radix_trie_bench.cpp
+ * @brief       Microbenchmarks of radix_trie operations.
+ *
+ * @details     Measures ns/op, ops/s and peak RSS growth of insert, find
+ *              (hits and misses), remove, complete, iteration and parallel
+ *              insertion with 1, 2, 4, ... hardware threads over several
+ *              datasets (see datasets.hpp) and sizes, and prints the results
+ *              as JSON.
+ *
+ *              Usage: radix-trie-bench [--sizes=N,N,...]
+ *                                      [--datasets=NAME,NAME,...]
+ *                                      [--seed=N]
+ *
+ *              Sizes accept scientific notation, e.g. --sizes=1e3,1e8. The
+ *              default sizes are 1e3 to 1e6.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#include "datasets.hpp"
+#include "radix_trie.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <iostream>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifndef RADIX_TRIE_VERSION
+#define RADIX_TRIE_VERSION "unknown"
+#endif
+
+namespace {
+
+using namespace radix_trie;
+
+/**
+ * @brief Peak resident set size of this process, in bytes.
+ */
+size_t peak_rss() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<size_t>(usage.ru_maxrss) * 1024;
+}
+
+/**
+ * @brief Times a callable that performs n operations.
+ *
+ * @return      Nanoseconds per operation.
+ */
+template <typename F> double time_ns_per_op(size_t n, F &&fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+         static_cast<double>(std::max<size_t>(n, 1));
+}
+
+/**
+ * @brief Prevents the compiler from discarding a benchmark result.
+ */
+volatile size_t sink;
+
+/**
+ * @brief Runs every operation on one key set and prints one JSON object per
+ * operation.
+ *
+ * @param dataset   The key generator.
+ * @param n         Number of keys.
+ * @param seed      Seed of the key generator.
+ * @param first     Whether these are the first results printed.
+ */
+void run_case(const datasets::Dataset &dataset, size_t n, uint64_t seed,
+              bool first) {
+  std::vector<std::string> keys = dataset.generate(n, seed);
+  std::vector<std::string> lookups = keys;
+  datasets::Rng rng(seed + 1);
+  for (size_t i = lookups.size(); i > 1; i--)
+    std::swap(lookups[i - 1], lookups[rng.below(i)]);
+
+  std::vector<std::string> misses = lookups;
+  for (auto &key : misses)
+    key += '\x01';
+
+  std::vector<std::string> prefixes;
+  for (size_t i = 0; i < std::min<size_t>(n, 1000); i++)
+    prefixes.push_back(lookups[i].substr(0, lookups[i].size() * 3 / 4));
+
+  // The peak RSS is the high-water mark of the process, so it only grows
+  // from one operation to the next. Each operation reports by how much it
+  // raised the mark.
+  Radix_Trie trie;
+  auto report = [&](std::string_view op, size_t ops, double ns,
+                    size_t rss_growth) {
+    std::cout << std::format(
+        "{}    {{\"dataset\": \"{}\", \"size\": {}, \"op\": \"{}\", "
+        "\"ops\": {}, \"ns_per_op\": {:.2f}, \"ops_per_sec\": {:.0f}, "
+        "\"peak_rss_growth_bytes\": {}}}",
+        first ? "" : ",\n", dataset.name, n, op, ops, ns, 1e9 / ns,
+        rss_growth);
+    first = false;
+  };
+  auto run = [&](std::string_view op, size_t ops, auto &&fn) {
+    size_t rss_before = peak_rss();
+    double ns = time_ns_per_op(ops, fn);
+    report(op, ops, ns, peak_rss() - rss_before);
+  };
+
+  run("insert", n, [&] {
+    for (const auto &key : keys)
+      trie.insert(key);
+  });
+
+  run("find_hit", n, [&] {
+    size_t found = 0;
+    for (const auto &key : lookups)
+      found += trie.find(key).has_value();
+    sink = found;
+  });
+
+  run("find_miss", n, [&] {
+    size_t found = 0;
+    for (const auto &key : misses)
+      found += trie.find(key).has_value();
+    sink = found;
+  });
+
+  run("complete", prefixes.size(), [&] {
+    size_t completed = 0;
+    std::vector<std::string> out_vec;
+    for (const auto &pref : prefixes) {
+      out_vec.clear();
+      trie.complete(pref, out_vec);
+      completed += out_vec.size();
+    }
+    sink = completed;
+  });
+
+  // Visits every word without copying it, so this times the traversal and
+  // not the allocation of n strings.
+  size_t visited = 0;
+  size_t rss_before = peak_rss();
+  double iterate_ns = time_ns_per_op(1, [&] {
+    trie.for_each([&visited](std::string_view) { visited++; });
+  });
+  sink = visited;
+  report("iterate", visited,
+         iterate_ns / static_cast<double>(std::max<size_t>(visited, 1)),
+         peak_rss() - rss_before);
+
+  run("remove", n, [&] {
+    size_t removed = 0;
+    for (const auto &key : lookups)
+      removed += trie.remove(key);
+    sink = removed;
+  });
+
+  // Run last, so the tries built here do not hide the growth of the
+  // operations above.
+  size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+  for (size_t n_threads = 1; n_threads <= max_threads; n_threads *= 2) {
+    Radix_Trie built;
+    run(std::format("insert_parallel_{}", n_threads), n,
+        [&] { built.insert_parallel(keys, n_threads); });
+  }
+  std::cout.flush();
+}
+
+/**
+ * @brief Splits a comma-separated list.
+ */
+std::vector<std::string> split(std::string_view list) {
+  std::vector<std::string> items;
+  for (auto part : list | std::views::split(','))
+    if (!part.empty())
+      items.emplace_back(part.begin(), part.end());
+  return items;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::vector<size_t> sizes = {1'000, 10'000, 100'000, 1'000'000};
+  std::vector<std::string> names;
+  for (const auto &dataset : datasets::all)
+    names.emplace_back(dataset.name);
+  uint64_t seed = 42;
+
+  try {
+    for (int i = 1; i < argc; i++) {
+      std::string_view arg = argv[i];
+      if (arg.starts_with("--sizes=")) {
+        sizes.clear();
+        for (const auto &item : split(arg.substr(8)))
+          sizes.push_back(static_cast<size_t>(std::stod(item)));
+      } else if (arg.starts_with("--datasets=")) {
+        names = split(arg.substr(11));
+      } else if (arg.starts_with("--seed=")) {
+        seed = std::stoull(std::string(arg.substr(7)));
+      } else {
+        throw std::invalid_argument(std::format(
+            "Invalid argument \"{}\". Valid arguments are --sizes=N,..., "
+            "--datasets=NAME,..., --seed=N.",
+            arg));
+      }
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+
+  std::cout << std::format("{{\n  \"benchmark\": \"radix-trie\",\n"
+                           "  \"version\": \"{}\",\n  \"seed\": {},\n"
+                           "  \"results\": [\n",
+                           RADIX_TRIE_VERSION, seed);
+  std::cout.flush();
+
+  // Every case runs in its own process, so its peak RSS starts from scratch.
+  bool first = true;
+  for (const auto &name : names) {
+    auto dataset = std::ranges::find(datasets::all, name,
+                                     &datasets::Dataset::name);
+    if (dataset == datasets::all.end()) {
+      std::cerr << std::format("Unknown dataset \"{}\".\n", name);
+      return 1;
+    }
+
+    for (size_t n : sizes) {
+      pid_t pid = fork();
+      if (pid == 0) {
+        run_case(*dataset, n, seed, first);
+        _exit(0);
+      }
+
+      int status = 0;
+      if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) ||
+          WEXITSTATUS(status) != 0) {
+        std::cerr << std::format("Benchmark {} with {} keys failed.\n", name,
+                                 n);
+        return 1;
+      }
+      first = false;
+    }
+  }
+
+  std::cout << "\n  ]\n}\n";
+  return 0;
+}
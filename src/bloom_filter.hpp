@@ -0,0 +1,149 @@
+/**
+ * @file        bloom_filter.hpp
+ * @brief       Blocked Bloom filter for fast negative lookups.
+ *
+ * @details     A split-block Bloom filter: every key sets one bit in each of
+ *              the eight 32-bit words of a single 32-byte block, so a query
+ *              reads one cache line.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace radix_trie {
+
+/**
+ * @brief A blocked Bloom filter over strings.
+ *
+ * The upper half of a key's 64-bit hash picks a block, and the lower half,
+ * multiplied by eight odd salts, picks one bit in each word of the block.
+ * With 10 bits per key the false positive rate is about 1%. Keys cannot be
+ * removed; rebuild the filter instead.
+ */
+class Blocked_Bloom_Filter {
+public:
+  /**
+   * @brief Constructs an empty filter sized for a number of keys.
+   *
+   * Space complexity:  O(n*b); n is the number of keys, b is the number of
+   *                    bits per key.
+   * Time complexity:   O(n*b).
+   *
+   * @param n_keys          Number of keys the filter is sized for.
+   * @param bits_per_key    Bits of filter per key. Default is 10.
+   * @throws                std::invalid_argument if bits_per_key is not
+   *                        positive.
+   */
+  explicit Blocked_Bloom_Filter(size_t n_keys, double bits_per_key = 10)
+      : _n_keys(n_keys) {
+    if (!(bits_per_key > 0))
+      throw std::invalid_argument(
+          "Invalid bits per key. It must be greater than 0.");
+    double bits = std::ceil(static_cast<double>(std::max<size_t>(n_keys, 1)) *
+                            bits_per_key);
+    _blocks.resize(std::max<size_t>(
+        static_cast<size_t>(bits / (8 * sizeof(_Block))), 1));
+  }
+
+  /**
+   * @brief Hashes a key, for insert_hash() and may_contain_hash().
+   */
+  static uint64_t hash(std::string_view key) {
+    uint64_t h = std::hash<std::string_view>{}(key);
+    // Mix, since std::hash may be weak in the bits used to pick a block.
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111eb;
+    return h ^ (h >> 31);
+  }
+
+  /**
+   * @brief Adds a key.
+   *
+   * Space complexity:  O(1).
+   * Time complexity:   O(l); l is the length of the key.
+   *
+   * @param key         The key to add.
+   */
+  void insert(std::string_view key) { insert_hash(hash(key)); }
+
+  /**
+   * @brief Adds a key by its hash.
+   */
+  void insert_hash(uint64_t h) {
+    _Block &block = _blocks[_block_index(h)];
+    auto key = static_cast<uint32_t>(h);
+    for (size_t i = 0; i < block.size(); i++)
+      block[i] |= _bit(key, i);
+  }
+
+  /**
+   * @brief Checks whether a key may have been added.
+   *
+   * Space complexity:  O(1).
+   * Time complexity:   O(l); l is the length of the key.
+   *
+   * @param key         The key to check.
+   * @return            False if the key was certainly not added, else true.
+   */
+  bool may_contain(std::string_view key) const {
+    return may_contain_hash(hash(key));
+  }
+
+  /**
+   * @brief Checks whether a key may have been added, by its hash.
+   */
+  bool may_contain_hash(uint64_t h) const {
+    const _Block &block = _blocks[_block_index(h)];
+    auto key = static_cast<uint32_t>(h);
+    uint32_t missing = 0;
+    for (size_t i = 0; i < block.size(); i++)
+      missing |= _bit(key, i) & ~block[i];
+    return missing == 0;
+  }
+
+  /**
+   * @brief Returns the number of keys the filter was sized for.
+   */
+  size_t capacity() const { return _n_keys; }
+
+  /**
+   * @brief Returns the size of the filter in bytes.
+   */
+  size_t size_bytes() const { return _blocks.size() * sizeof(_Block); }
+
+private:
+  /**
+   * @brief A block: eight 32-bit words, aligned so it never straddles a
+   * cache line.
+   */
+  struct alignas(32) _Block : std::array<uint32_t, 8> {};
+
+  static constexpr std::array<uint32_t, 8> _salts = {
+      0x47b6137b, 0x44974d91, 0x8824ad5b, 0xa2b7289d,
+      0x705495c7, 0x2df1424b, 0x9efc4947, 0x5c6bfb31};
+
+  std::vector<_Block> _blocks;
+  size_t _n_keys;
+
+  size_t _block_index(uint64_t h) const {
+    return static_cast<size_t>(((h >> 32) * _blocks.size()) >> 32);
+  }
+
+  static uint32_t _bit(uint32_t key, size_t word) {
+    return uint32_t{1} << ((key * _salts[word]) >> 27);
+  }
+};
+
+} // namespace radix_trie
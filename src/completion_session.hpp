@@ -0,0 +1,196 @@
+/**
+ * @file        completion_session.hpp
+ * @brief       Incremental type-ahead completion over a radix trie.
+ *
+ * @details     Keeps the position of a growing prefix in the trie, so typing
+ *              or deleting a character moves one step instead of descending
+ *              from the root again.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#pragma once
+
+#include "radix_trie.hpp"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace radix_trie {
+
+/**
+ * @brief A prefix that is edited one character at a time, together with its
+ * position in a trie.
+ *
+ * Every character typed records the node it led to and how much of that
+ * node's label is matched, so push() costs one child lookup or one byte
+ * comparison and pop() just drops the last position. Characters typed after
+ * the prefix left the trie are only counted, until enough are deleted.
+ *
+ * The session borrows the trie. Any change to the trie invalidates the
+ * session; call reset() and push the prefix again afterwards.
+ */
+class Completion_Session {
+public:
+  /**
+   * @brief Starts a session with an empty prefix.
+   *
+   * @param trie        The trie to complete against. It must outlive the
+   *                    session.
+   */
+  explicit Completion_Session(const Radix_Trie &trie)
+      : _trie(trie), _positions{{trie._root, 0}} {}
+
+  /**
+   * @brief Appends a character to the prefix.
+   *
+   * Space complexity:  O(1).
+   * Time complexity:   O(1).
+   *
+   * @param c           The character typed.
+   */
+  void push(char c) {
+    _prefix.push_back(c);
+    if (_unmatched > 0) {
+      _unmatched++;
+      return;
+    }
+
+    auto [node, offset] = _positions.back();
+    if (offset < node->val.size()) {
+      RADIX_TRIE_COUNT(bytes_compared, 1);
+      if (node->val[offset] == c)
+        _positions.push_back({node, offset + 1});
+      else
+        _unmatched++;
+      return;
+    }
+
+    auto it = node->children.find(c);
+    if (it == node->children.end()) {
+      _unmatched++;
+      return;
+    }
+    RADIX_TRIE_COUNT(nodes_visited, 1);
+    _positions.push_back({it->second, 1});
+  }
+
+  /**
+   * @brief Appends several characters to the prefix.
+   *
+   * Space complexity:  O(n); n is the length of the text.
+   * Time complexity:   O(n).
+   *
+   * @param text        The characters typed.
+   */
+  void push(std::string_view text) {
+    for (char c : text)
+      push(c);
+  }
+
+  /**
+   * @brief Deletes characters from the end of the prefix.
+   *
+   * Space complexity:  O(1).
+   * Time complexity:   O(n); n is the number of characters deleted.
+   *
+   * @param n           Number of characters to delete. Default is 1.
+   * @throws            std::out_of_range if the prefix is shorter than n.
+   */
+  void pop(size_t n = 1) {
+    if (n > _prefix.size())
+      throw std::out_of_range(
+          std::format("Cannot delete {} characters from a prefix of {}.", n,
+                      _prefix.size()));
+
+    _prefix.resize(_prefix.size() - n);
+    size_t from_unmatched = std::min(n, _unmatched);
+    _unmatched -= from_unmatched;
+    _positions.resize(_positions.size() - (n - from_unmatched));
+  }
+
+  /**
+   * @brief Clears the prefix and returns to the root of the trie.
+   */
+  void reset() {
+    _prefix.clear();
+    _positions.resize(1);
+    _positions.front() = {_trie._root, 0};
+    _unmatched = 0;
+  }
+
+  /**
+   * @brief Returns the prefix typed so far.
+   */
+  const std::string &prefix() const { return _prefix; }
+
+  /**
+   * @brief Checks whether any stored path starts with the prefix.
+   */
+  bool matches() const { return _unmatched == 0; }
+
+  /**
+   * @brief Checks whether the prefix itself is a stored word.
+   */
+  bool is_word() const {
+    auto [node, offset] = _positions.back();
+    return matches() && offset == node->val.size() && node->is_word;
+  }
+
+  /**
+   * @brief Finds all completions of the prefix that form a word, as
+   * Radix_Trie::complete() does, starting from the saved position.
+   *
+   * Space complexity:  O(n); n is the size of the out_vec.
+   * Time complexity:   O(h); h is number of nodes in the relevant subtree.
+   *
+   * @param out_vec     A vector of strings that should be populated with
+   *                    completions.
+   */
+  void complete(std::vector<std::string> &out_vec) const {
+    RADIX_TRIE_TIME(complete);
+    if (!matches())
+      return;
+
+    [[maybe_unused]] size_t before = out_vec.size();
+    auto [node, offset] = _positions.back();
+    _trie._complete(node, out_vec, node->val.substr(offset));
+    RADIX_TRIE_RECORD(complete_results, out_vec.size() - before);
+  }
+
+private:
+  /**
+   * @brief A point in the trie: a node and the number of characters of its
+   * label matched so far.
+   */
+  struct _Position {
+    const Radix_Node *node;
+    size_t offset;
+  };
+
+  const Radix_Trie &_trie;
+
+  /**
+   * @brief The prefix typed so far.
+   */
+  std::string _prefix;
+
+  /**
+   * @brief The position after each matched character, starting with the
+   * root for the empty prefix.
+   */
+  std::vector<_Position> _positions;
+
+  /**
+   * @brief Characters typed after the prefix stopped matching.
+   */
+  size_t _unmatched = 0;
+};
+
+} // namespace radix_trie
@@ -0,0 +1,158 @@
+/**
+ * @file        encoded_radix_trie.hpp
+ * @brief       Radix trie over order-preserving compressed keys.
+ *
+ * @details     Encodes every key with an Order_Preserving_Encoder before it
+ *              reaches the trie, which shortens node labels and the trie's
+ *              height while keeping keys in order.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#pragma once
+
+#include "order_preserving_encoder.hpp"
+#include "radix_trie.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace radix_trie {
+
+/**
+ * @brief A Radix Trie that stores its words encoded by an
+ * Order_Preserving_Encoder.
+ *
+ * Since encodings do not share the prefixes of their keys, a completion is
+ * a scan over the range of encodings its prefix maps to. Children are
+ * visited in byte order during the scan, so completions come out sorted.
+ */
+class Encoded_Radix_Trie {
+public:
+  /**
+   * @brief Constructs an empty trie.
+   *
+   * @param encoder     The encoder applied to every word, usually trained on
+   *                    a sample of the words to be stored.
+   */
+  explicit Encoded_Radix_Trie(Order_Preserving_Encoder encoder)
+      : _encoder(std::move(encoder)) {}
+
+  /**
+   * @brief Inserts a word into the trie.
+   *
+   * Space complexity:  O(n); n is the length of the word.
+   * Time complexity:   O(n*log(d)); d is the number of dictionary grams.
+   *
+   * @param word        The word to insert.
+   */
+  void insert(std::string_view word) { _trie.insert(_encoder.encode(word)); }
+
+  /**
+   * @brief Removes a word from the trie.
+   *
+   * Space complexity:  O(n); n is the length of the word.
+   * Time complexity:   O(n*log(d)); d is the number of dictionary grams.
+   *
+   * @param word        The word to remove.
+   * @return            True if the word was stored, else false.
+   */
+  bool remove(std::string_view word) {
+    return _trie.remove(_encoder.encode(word));
+  }
+
+  /**
+   * @brief Checks whether a word is stored.
+   *
+   * Space complexity:  O(n); n is the length of the word.
+   * Time complexity:   O(n*log(d)); d is the number of dictionary grams.
+   *
+   * @param word        The word to search for.
+   * @return            True if the word is stored, else false.
+   */
+  bool contains(std::string_view word) const {
+    return _trie.contains(_encoder.encode(word));
+  }
+
+  /**
+   * @brief Finds all completions for a given prefix that form a word, in
+   * lexicographic order. As with Radix_Trie::complete(), completions are
+   * returned without the prefix, and the prefix itself is not one.
+   *
+   * Subtrees whose encoded path lies wholly outside [encode(pref),
+   * encode(successor(pref))) are skipped, and the scan stops at the first
+   * word past the range.
+   *
+   * Space complexity:  O(n + h); n is the size of the out_vec, h is the
+   *                    height of the trie.
+   * Time complexity:   O(p + s); p is the length of the prefix, s is the
+   *                    number of nodes scanned.
+   *
+   * @param pref        A string that needs to be completed.
+   * @param out_vec     A vector of strings that should be populated with
+   *                    completions.
+   */
+  void complete(const std::string &pref,
+                std::vector<std::string> &out_vec) const {
+    std::string lo = _encoder.encode(pref);
+    std::optional<std::string> hi;
+    if (auto next = Order_Preserving_Encoder::successor(pref))
+      hi = _encoder.encode(*next);
+
+    struct Entry {
+      const Radix_Node *node;
+      size_t path_size;
+    };
+    std::vector<Entry> stack{{_trie.root(), 0}};
+    std::vector<std::pair<char, const Radix_Node *>> children;
+    std::string path;
+
+    while (!stack.empty()) {
+      auto [node, path_size] = stack.back();
+      stack.pop_back();
+      path.resize(path_size);
+      path += node->val;
+
+      if (hi && path >= *hi)
+        return;
+      if (path < lo && !lo.starts_with(path))
+        continue;
+
+      if (node->is_word && path >= lo) {
+        std::string word = _encoder.decode(path);
+        if (word.size() > pref.size())
+          out_vec.push_back(word.substr(pref.size()));
+      }
+
+      children.assign(node->children.begin(), node->children.end());
+      std::ranges::sort(children, std::ranges::greater(), [](const auto &c) {
+        return static_cast<unsigned char>(c.first);
+      });
+      for (const auto &child : children)
+        stack.push_back({child.second, path.size()});
+    }
+  }
+
+  /**
+   * @brief Returns the encoder.
+   */
+  const Order_Preserving_Encoder &encoder() const { return _encoder; }
+
+  /**
+   * @brief Returns the underlying trie of encoded words, for example to
+   * inspect its memory_usage() or stats().
+   */
+  const Radix_Trie &trie() const { return _trie; }
+
+private:
+  Order_Preserving_Encoder _encoder;
+  Radix_Trie _trie;
+};
+
+} // namespace radix_trie
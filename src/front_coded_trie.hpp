@@ -0,0 +1,472 @@
+/**
+ * @file        front_coded_trie.hpp
+ * @brief       Compressed, front-coded export format of a radix trie.
+ *
+ * @details     Contains the writer of the format and a reader that
+ *              memory-maps it and answers lookups and completions directly
+ *              on the compressed blocks.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#pragma once
+
+#include "radix_trie.hpp"
+#include "varint.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace radix_trie {
+
+/**
+ * @brief An immutable, compressed set of words that supports lookups and
+ * completions without decompressing it as a whole.
+ *
+ * Words are stored in lexicographic order, in blocks of a fixed number of
+ * words. The first word of a block is stored whole, as a varint length and
+ * its bytes. Every other word is front coded against its predecessor: a
+ * varint length of the shared prefix, a varint length of the rest and the
+ * rest. A sparse index holds, per block, its offset, its word count and its
+ * first word, so a query decodes a single block, or a run of blocks for a
+ * completion.
+ *
+ * The file starts with magic "RDXF" and a 32-bit little-endian version, and
+ * ends with the index followed by its 64-bit little-endian offset. The reader
+ * maps the file and keeps only the index in memory, so a query touches the
+ * pages of the blocks it decodes and nothing else.
+ */
+class Front_Coded_Trie {
+public:
+  /**
+   * @brief Memory-maps a compressed set file written by write(). Only the
+   * sparse index is read up front; the blocks are paged in by the queries
+   * that decode them, so a large archive never has to fit into memory.
+   *
+   * Space complexity:  O(b); b is the number of blocks.
+   * Time complexity:   O(b); b is the number of blocks.
+   *
+   * @param path        The file to map.
+   * @throws            std::system_error if the file cannot be mapped,
+   *                    std::runtime_error if it is not a valid set.
+   */
+  explicit Front_Coded_Trie(const std::filesystem::path &path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      throw std::system_error(
+          errno, std::generic_category(),
+          std::format("Failed to open \"{}\"", path.string()));
+
+    struct stat st;
+    if (::fstat(fd, &st) < 0) {
+      int err = errno;
+      ::close(fd);
+      throw std::system_error(err, std::generic_category(),
+                              std::format("Failed to stat \"{}\"",
+                                          path.string()));
+    }
+
+    _map_size = static_cast<size_t>(st.st_size);
+    if (_map_size < _min_size) {
+      ::close(fd);
+      throw std::runtime_error(std::format(
+          "\"{}\" is too small to be a front-coded trie.", path.string()));
+    }
+
+    void *map = ::mmap(nullptr, _map_size, PROT_READ, MAP_SHARED, fd, 0);
+    int err = errno;
+    ::close(fd);
+    if (map == MAP_FAILED)
+      throw std::system_error(err, std::generic_category(),
+                              std::format("Failed to map \"{}\"",
+                                          path.string()));
+
+    _map = map;
+    _data = static_cast<const char *>(map);
+    _size = _map_size;
+    try {
+      _parse();
+    } catch (...) {
+      _unmap();
+      throw;
+    }
+  }
+
+  /**
+   * @brief Wraps a compressed set that is already in memory. The memory is
+   * not owned and must outlive this object.
+   *
+   * Space complexity:  O(b); b is the number of blocks.
+   * Time complexity:   O(b); b is the number of blocks.
+   *
+   * @param data        The bytes written by write().
+   * @throws            std::runtime_error if the data is not a valid set.
+   */
+  explicit Front_Coded_Trie(std::span<const std::byte> data)
+      : _data(reinterpret_cast<const char *>(data.data())),
+        _size(data.size()) {
+    _parse();
+  }
+
+  Front_Coded_Trie(const Front_Coded_Trie &) = delete;
+  Front_Coded_Trie &operator=(const Front_Coded_Trie &) = delete;
+
+  Front_Coded_Trie(Front_Coded_Trie &&other) noexcept
+      : _data(std::exchange(other._data, nullptr)),
+        _size(std::exchange(other._size, 0)), _index(std::move(other._index)),
+        _n_words(std::exchange(other._n_words, 0)),
+        _map(std::exchange(other._map, nullptr)),
+        _map_size(std::exchange(other._map_size, 0)) {}
+
+  Front_Coded_Trie &operator=(Front_Coded_Trie &&other) noexcept {
+    if (this != &other) {
+      _unmap();
+      _data = std::exchange(other._data, nullptr);
+      _size = std::exchange(other._size, 0);
+      _index = std::move(other._index);
+      _n_words = std::exchange(other._n_words, 0);
+      _map = std::exchange(other._map, nullptr);
+      _map_size = std::exchange(other._map_size, 0);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Unmaps the file, if this object mapped it.
+   */
+  ~Front_Coded_Trie() { _unmap(); }
+
+  /**
+   * @brief Writes the words of a trie as a compressed set. The words are
+   * streamed out in order, so only the sparse index is kept in memory.
+   *
+   * Space complexity:  O(b + h); b is the number of blocks, h is the height
+   *                    of the trie.
+   * Time complexity:   O(n log k); n is the number of nodes, k is the
+   *                    largest fanout.
+   *
+   * @param trie        The trie to write.
+   * @param os          The stream to write to.
+   * @param block_size  Number of words per block. Default is 16.
+   * @throws            std::invalid_argument if block_size is 0,
+   *                    std::runtime_error if writing fails.
+   */
+  static void write(const Radix_Trie &trie, std::ostream &os,
+                    size_t block_size = 16) {
+    if (block_size == 0)
+      throw std::invalid_argument(
+          "Invalid block size 0. It must be at least 1.");
+
+    std::string buf(_magic);
+    _put_u32(buf, _version);
+    uint64_t written = 0;
+
+    std::string index;
+    uint64_t n_blocks = 0;
+    size_t in_block = 0;
+    size_t block_count_pos = 0;
+    std::string prev;
+
+    auto flush = [&] {
+      os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+      written += buf.size();
+      buf.clear();
+    };
+
+    auto emit = [&](const std::string &word) {
+      if (in_block == block_size)
+        in_block = 0;
+
+      if (in_block == 0) {
+        // The word count of the previous block is known only now.
+        if (n_blocks)
+          _patch_count(index, block_count_pos, block_size);
+        put_varint(index, written + buf.size());
+        block_count_pos = index.size();
+        index.append(_count_width, '\0');
+        put_varint(index, word.size());
+        index += word;
+        n_blocks++;
+
+        put_varint(buf, word.size());
+        buf += word;
+      } else {
+        size_t shared = static_cast<size_t>(
+            std::ranges::mismatch(prev, word).in2 - word.begin());
+        put_varint(buf, shared);
+        put_varint(buf, word.size() - shared);
+        buf.append(word, shared);
+      }
+
+      in_block++;
+      prev = word;
+      if (buf.size() >= (1 << 16))
+        flush();
+    };
+
+    // Preorder walk with children sorted by their first byte yields the
+    // words in lexicographic order.
+    std::vector<std::pair<const Radix_Node *, size_t>> stack{{trie.root(), 0}};
+    std::vector<const Radix_Node *> children;
+    std::string base;
+    while (!stack.empty()) {
+      auto [curr, base_size] = stack.back();
+      stack.pop_back();
+
+      base.resize(base_size);
+      base += curr->val;
+      if (curr->is_word)
+        emit(base);
+
+      children.clear();
+      for (const auto &entry : curr->children)
+        children.push_back(entry.second);
+      std::ranges::sort(children, std::greater{}, [](const Radix_Node *child) {
+        return static_cast<unsigned char>(child->val[0]);
+      });
+      for (const Radix_Node *child : children)
+        stack.emplace_back(child, base.size());
+    }
+
+    if (n_blocks)
+      _patch_count(index, block_count_pos, in_block);
+
+    flush();
+    uint64_t index_offset = written;
+    std::string tail;
+    put_varint(tail, n_blocks);
+    tail += index;
+    for (int i = 0; i < 8; i++)
+      tail.push_back(static_cast<char>(index_offset >> (8 * i)));
+    os.write(tail.data(), static_cast<std::streamsize>(tail.size()));
+    if (!os)
+      throw std::runtime_error("Failed to write front-coded trie.");
+  }
+
+  /**
+   * @brief Writes the words of a trie as a compressed set file. See
+   * write(const Radix_Trie &, std::ostream &, size_t).
+   *
+   * @param trie        The trie to write.
+   * @param path        The file to write to. It is overwritten.
+   * @param block_size  Number of words per block. Default is 16.
+   * @throws            std::runtime_error if the file cannot be written.
+   */
+  static void write(const Radix_Trie &trie, const std::filesystem::path &path,
+                    size_t block_size = 16) {
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    if (!os)
+      throw std::runtime_error(
+          std::format("Failed to open \"{}\" for writing.", path.string()));
+    write(trie, os, block_size);
+  }
+
+  /**
+   * @brief Checks whether a word is stored.
+   *
+   * Space complexity:  O(l); l is the length of the longest word in a block.
+   * Time complexity:   O(log b + k*l); b is the number of blocks, k is the
+   *                    block size, l is the length of the longest word in
+   *                    a block.
+   *
+   * @param word        The word to search for.
+   * @return            True if the word is stored, else false.
+   */
+  bool contains(std::string_view word) const {
+    bool found = false;
+    _scan(word, [&](std::string_view curr) {
+      found = curr == word;
+      return curr < word;
+    });
+    return found;
+  }
+
+  /**
+   * @brief Finds all completions for a given prefix that form a word, in
+   * lexicographic order. Like Radix_Trie::complete(), the completions are
+   * the remainders after the prefix, and the prefix itself is not included.
+   *
+   * Space complexity:  O(n); n is the size of the out_vec.
+   * Time complexity:   O(log b + m*l); b is the number of blocks, m is the
+   *                    number of words decoded, l is their length.
+   *
+   * @param pref        A string that needs to be completed.
+   * @param out_vec     A vector of strings that should be populated with
+   *                    completions.
+   */
+  void complete(std::string_view pref,
+                std::vector<std::string> &out_vec) const {
+    _scan(pref, [&](std::string_view curr) {
+      if (curr.starts_with(pref)) {
+        if (curr.size() > pref.size())
+          out_vec.emplace_back(curr.substr(pref.size()));
+        return true;
+      }
+      return curr < pref;
+    });
+  }
+
+  /**
+   * @brief Returns the number of stored words.
+   */
+  size_t size() const { return _n_words; }
+
+private:
+  /**
+   * @brief Index entry of a block.
+   */
+  struct _Block {
+    size_t offset;
+    size_t n_words;
+    std::string first;
+  };
+
+  static constexpr std::string_view _magic = "RDXF";
+  static constexpr uint32_t _version = 1;
+
+  /**
+   * @brief Fixed width of the word count varints in the index, so they can
+   * be patched in place once a block is complete.
+   */
+  static constexpr size_t _count_width = 5;
+
+  /**
+   * @brief Smallest valid set: the header, an empty index and its offset.
+   */
+  static constexpr size_t _min_size = 17;
+
+  const char *_data = nullptr;
+  size_t _size = 0;
+  std::vector<_Block> _index;
+  size_t _n_words = 0;
+
+  /**
+   * @brief The mapping, if this object owns one.
+   */
+  void *_map = nullptr;
+  size_t _map_size = 0;
+
+  void _unmap() {
+    if (_map)
+      ::munmap(_map, _map_size);
+    _map = nullptr;
+  }
+
+  static void _put_u32(std::string &out, uint32_t val) {
+    for (int i = 0; i < 4; i++)
+      out.push_back(static_cast<char>(val >> (8 * i)));
+  }
+
+  /**
+   * @brief Writes a word count as a varint padded to _count_width bytes.
+   */
+  static void _patch_count(std::string &index, size_t pos, uint64_t count) {
+    for (size_t i = 0; i < _count_width; i++) {
+      char byte = static_cast<char>(count & 0x7f);
+      count >>= 7;
+      if (i + 1 < _count_width)
+        byte |= static_cast<char>(0x80);
+      index[pos + i] = byte;
+    }
+  }
+
+  /**
+   * @brief Validates the header and loads the sparse index.
+   *
+   * @throws            std::runtime_error if the data is not a valid set.
+   */
+  void _parse() {
+    size_t header_size = _magic.size() + 4;
+    std::string_view data(_data, _size);
+    if (_size < _min_size || !data.starts_with(_magic))
+      throw std::runtime_error("Not a front-coded trie: bad magic.");
+
+    uint32_t version = 0;
+    for (int i = 0; i < 4; i++)
+      version |= static_cast<uint32_t>(
+                     static_cast<unsigned char>(_data[_magic.size() + i]))
+                 << (8 * i);
+    if (version != _version)
+      throw std::runtime_error(
+          std::format("Unsupported front-coded trie version {}.", version));
+
+    uint64_t index_offset = 0;
+    for (int i = 0; i < 8; i++)
+      index_offset |= static_cast<uint64_t>(
+                          static_cast<unsigned char>(_data[_size - 8 + i]))
+                      << (8 * i);
+    if (index_offset < header_size || index_offset > _size - 8)
+      throw std::runtime_error("Corrupt front-coded trie: bad index offset.");
+
+    const char *pos = _data + index_offset;
+    const char *end = _data + _size - 8;
+    uint64_t n_blocks = get_varint(pos, end);
+    for (uint64_t i = 0; i < n_blocks; i++) {
+      size_t offset = get_varint(pos, end);
+      size_t n_words = get_varint(pos, end);
+      size_t first_size = get_varint(pos, end);
+      if (offset < header_size || offset >= index_offset || n_words == 0 ||
+          first_size > static_cast<size_t>(end - pos))
+        throw std::runtime_error("Corrupt front-coded trie: bad index.");
+      _index.push_back({offset, n_words, std::string(pos, first_size)});
+      pos += first_size;
+      _n_words += n_words;
+    }
+  }
+
+  /**
+   * @brief Decodes words in order, starting from the block that may hold a
+   * given key, for as long as a visitor asks for more.
+   *
+   * @param key         The key whose block to start from.
+   * @param visit       Callable invoked with each decoded word; returns
+   *                    whether to continue.
+   */
+  template <typename F> void _scan(std::string_view key, F &&visit) const {
+    // Last block whose first word is not greater than the key.
+    auto it = std::ranges::upper_bound(_index, key, {}, [](const _Block &b) {
+      return std::string_view(b.first);
+    });
+    if (it != _index.begin())
+      --it;
+
+    const char *data_end = _data + _size;
+    std::string curr;
+    for (; it != _index.end(); ++it) {
+      const char *pos = _data + it->offset;
+      for (size_t i = 0; i < it->n_words; i++) {
+        size_t shared = i ? get_varint(pos, data_end) : 0;
+        size_t rest = get_varint(pos, data_end);
+        if (shared > curr.size() ||
+            rest > static_cast<size_t>(data_end - pos))
+          throw std::runtime_error("Corrupt front-coded trie: bad block.");
+
+        curr.resize(shared);
+        curr.append(pos, rest);
+        pos += rest;
+        if (!visit(std::string_view(curr)))
+          return;
+      }
+    }
+  }
+};
+
+} // namespace radix_trie
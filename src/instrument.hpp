@@ -0,0 +1,270 @@
+/**
+ * @file        instrument.hpp
+ * @brief       Compile-time switchable instrumentation of radix trie.
+ *
+ * @details     Contains operation counters and lock-free log-linear
+ *              histograms, and the macros the trie uses to feed them. Define
+ *              RADIX_TRIE_INSTRUMENT to enable the macros; otherwise they
+ *              expand to nothing and their arguments are not evaluated.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+namespace radix_trie::instrument {
+
+/**
+ * @brief A lock-free histogram of non-negative values with bounded relative
+ * error, in the style of HdrHistogram.
+ *
+ * Values below 16 have a bucket each. Every larger power-of-two range is
+ * split into 16 linear buckets, so a value is reported with an error of at
+ * most 1/16. Recording is a relaxed atomic increment, so any number of
+ * threads may record concurrently.
+ */
+class Histogram {
+public:
+  /**
+   * @brief Records a value.
+   *
+   * Space complexity:  O(1).
+   * Time complexity:   O(1).
+   *
+   * @param val         The value to record.
+   */
+  void record(uint64_t val) {
+    _buckets[_index(val)].fetch_add(1, std::memory_order_relaxed);
+    uint64_t max = _max.load(std::memory_order_relaxed);
+    while (val > max &&
+           !_max.compare_exchange_weak(max, val, std::memory_order_relaxed))
+      ;
+  }
+
+  /**
+   * @brief Returns the number of recorded values.
+   */
+  uint64_t count() const {
+    uint64_t total = 0;
+    for (const auto &bucket : _buckets)
+      total += bucket.load(std::memory_order_relaxed);
+    return total;
+  }
+
+  /**
+   * @brief Returns the largest recorded value, exactly.
+   */
+  uint64_t max() const { return _max.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Returns the value below or at which a given percentage of the
+   * recorded values lie, as the upper end of its bucket.
+   *
+   * Space complexity:  O(1).
+   * Time complexity:   O(b); b is the number of buckets.
+   *
+   * @param p           The percentile, in [0, 100].
+   * @return            The percentile value, or 0 if nothing was recorded.
+   */
+  uint64_t percentile(double p) const {
+    uint64_t total = count();
+    if (total == 0)
+      return 0;
+
+    auto target = static_cast<uint64_t>(p / 100 * static_cast<double>(total));
+    target = std::max<uint64_t>(target, 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < _buckets.size(); i++) {
+      seen += _buckets[i].load(std::memory_order_relaxed);
+      if (seen >= target)
+        return std::min(_upper(i), max());
+    }
+    return max();
+  }
+
+  /**
+   * @brief Forgets all recorded values.
+   */
+  void reset() {
+    for (auto &bucket : _buckets)
+      bucket.store(0, std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  static constexpr unsigned _sub_bits = 4;
+  static constexpr uint64_t _sub_count = uint64_t{1} << _sub_bits;
+  static constexpr size_t _n_buckets = _sub_count * (65 - _sub_bits);
+
+  std::array<std::atomic<uint64_t>, _n_buckets> _buckets{};
+  std::atomic<uint64_t> _max{0};
+
+  /**
+   * @brief Maps a value to its bucket.
+   */
+  static size_t _index(uint64_t val) {
+    if (val < _sub_count)
+      return val;
+    unsigned shift = std::bit_width(val) - 1 - _sub_bits;
+    return _sub_count * (shift + 1) + ((val >> shift) - _sub_count);
+  }
+
+  /**
+   * @brief Returns the largest value that maps to a bucket.
+   */
+  static uint64_t _upper(size_t idx) {
+    if (idx < _sub_count)
+      return idx;
+    unsigned shift = static_cast<unsigned>(idx / _sub_count - 1);
+    uint64_t lower = (_sub_count + idx % _sub_count) << shift;
+    return lower + ((uint64_t{1} << shift) - 1);
+  }
+};
+
+/**
+ * @brief Counters of the work done by trie operations.
+ */
+struct Counters {
+  /**
+   * @brief Nodes entered while descending or walking the trie.
+   */
+  std::atomic<uint64_t> nodes_visited{0};
+
+  /**
+   * @brief Label bytes compared against the key.
+   */
+  std::atomic<uint64_t> bytes_compared{0};
+
+  /**
+   * @brief Nodes split on insertion.
+   */
+  std::atomic<uint64_t> splits{0};
+
+  /**
+   * @brief Nodes merged into their single child on removal.
+   */
+  std::atomic<uint64_t> merges{0};
+
+  /**
+   * @brief Nodes allocated and freed.
+   */
+  std::atomic<uint64_t> allocs{0};
+  std::atomic<uint64_t> frees{0};
+
+  void reset() {
+    for (auto *counter : {&nodes_visited, &bytes_compared, &splits, &merges,
+                          &allocs, &frees})
+      counter->store(0, std::memory_order_relaxed);
+  }
+};
+
+/**
+ * @brief Latencies of trie operations, in nanoseconds, and the number of
+ * results of each completion. Slow completions usually return many results;
+ * comparing the tails of both histograms tells whether they do.
+ *
+ * Every completion call adds one sample to both completion histograms:
+ * complete(), complete_parallel(), complete_batch() and
+ * Completion_Session::complete(). A batch counts as one call, with its total
+ * number of results.
+ */
+struct Latencies {
+  Histogram insert;
+  Histogram find;
+  Histogram remove;
+  Histogram complete;
+  Histogram complete_results;
+
+  void reset() {
+    for (auto *hist : {&insert, &find, &remove, &complete, &complete_results})
+      hist->reset();
+  }
+};
+
+/**
+ * @brief Process-wide counters, shared by every trie.
+ */
+inline Counters counters;
+
+/**
+ * @brief Process-wide latency histograms, shared by every trie.
+ */
+inline Latencies latencies;
+
+/**
+ * @brief Records the lifetime of a scope into a histogram, in nanoseconds.
+ */
+class Scoped_Timer {
+public:
+  explicit Scoped_Timer(Histogram &hist)
+      : _hist(hist), _start(std::chrono::steady_clock::now()) {}
+
+  Scoped_Timer(const Scoped_Timer &) = delete;
+  Scoped_Timer &operator=(const Scoped_Timer &) = delete;
+
+  ~Scoped_Timer() {
+    auto elapsed = std::chrono::steady_clock::now() - _start;
+    _hist.record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+  }
+
+private:
+  Histogram &_hist;
+  std::chrono::steady_clock::time_point _start;
+};
+
+/**
+ * @brief Returns the counters and the percentiles of every histogram as
+ * text, one line each.
+ */
+inline std::string summary() {
+  std::string out = std::format(
+      "nodes_visited={} bytes_compared={} splits={} merges={} allocs={} "
+      "frees={}\n",
+      counters.nodes_visited.load(), counters.bytes_compared.load(),
+      counters.splits.load(), counters.merges.load(), counters.allocs.load(),
+      counters.frees.load());
+
+  auto line = [&out](std::string_view name, const Histogram &hist) {
+    out += std::format("{}: count={} p50={} p90={} p99={} p999={} max={}\n",
+                       name, hist.count(), hist.percentile(50),
+                       hist.percentile(90), hist.percentile(99),
+                       hist.percentile(99.9), hist.max());
+  };
+  line("insert_ns", latencies.insert);
+  line("find_ns", latencies.find);
+  line("remove_ns", latencies.remove);
+  line("complete_ns", latencies.complete);
+  line("complete_results", latencies.complete_results);
+  return out;
+}
+
+} // namespace radix_trie::instrument
+
+#ifdef RADIX_TRIE_INSTRUMENT
+#define RADIX_TRIE_COUNT(counter, n)                                           \
+  ::radix_trie::instrument::counters.counter.fetch_add(                        \
+      (n), std::memory_order_relaxed)
+#define RADIX_TRIE_RECORD(hist, val)                                           \
+  ::radix_trie::instrument::latencies.hist.record(val)
+#define RADIX_TRIE_TIME(hist)                                                  \
+  ::radix_trie::instrument::Scoped_Timer radix_trie_timer_(                    \
+      ::radix_trie::instrument::latencies.hist)
+#else
+#define RADIX_TRIE_COUNT(counter, n) ((void)0)
+#define RADIX_TRIE_RECORD(hist, val) ((void)0)
+#define RADIX_TRIE_TIME(hist) ((void)0)
+#endif
@@ -0,0 +1,392 @@
+/**
+ * @file        logged_radix_trie.hpp
+ * @brief       Radix trie with a write-ahead log of its mutations.
+ *
+ * @details     Records every insert and remove in an append-only log with
+ *              group commit, and recovers by replaying the log on top of the
+ *              latest snapshot written by Radix_Trie::save().
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#pragma once
+
+#include "radix_trie.hpp"
+#include "varint.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace radix_trie {
+
+/**
+ * @brief A Radix Trie whose mutations are made durable through a
+ * write-ahead log (WAL).
+ *
+ * Mutations are applied to the in-memory trie at once and appended to an
+ * in-memory log buffer. The buffer is written and synced as one group once it
+ * reaches the group size, once its oldest record has waited the group delay,
+ * or when commit() is called. A crash therefore loses at most one group:
+ * less than the group size, and no mutation older than the group delay at
+ * the time of the latest mutation. There is no background flusher, so the
+ * delay is only checked on the next mutation; a caller that may go idle with
+ * records pending should call commit(). checkpoint() writes a fresh snapshot
+ * and empties the log.
+ *
+ * The log starts with magic "RDXW" and a version byte. Each record is an
+ * operation byte, the varint word length, the word and a 32-bit FNV-1a
+ * checksum of the operation and the word. Replay stops at the first torn or
+ * corrupt record, and the log is cut back to the last valid one.
+ */
+class Logged_Radix_Trie {
+public:
+  /**
+   * @brief Opens a logged trie, recovering its state from the snapshot and
+   * the log if they exist.
+   *
+   * Space complexity:  O(s); s is the size of the snapshot and the log.
+   * Time complexity:   O(n + m); n is the number of nodes in the snapshot,
+   *                    m is the total length of the logged words.
+   *
+   * @param snapshot_path   File holding the latest snapshot.
+   * @param wal_path        File holding the log.
+   * @param group_bytes     Buffered log size that triggers a group commit.
+   *                        Default is 64 KiB.
+   * @param sync            Whether group commits are synced to disk. Default
+   *                        is true.
+   * @param group_delay     Age of the oldest buffered record that triggers a
+   *                        group commit on the next mutation. Default is
+   *                        10 ms.
+   * @throws                std::system_error if a file cannot be accessed,
+   *                        std::runtime_error if the snapshot is invalid.
+   */
+  Logged_Radix_Trie(std::filesystem::path snapshot_path,
+                    std::filesystem::path wal_path,
+                    size_t group_bytes = 1 << 16, bool sync = true,
+                    std::chrono::microseconds group_delay =
+                        std::chrono::milliseconds(10))
+      : _snapshot_path(std::move(snapshot_path)),
+        _wal_path(std::move(wal_path)), _group_bytes(group_bytes),
+        _sync(sync), _group_delay(group_delay) {
+    if (std::filesystem::exists(_snapshot_path))
+      _trie.load(_snapshot_path);
+
+    _fd = ::open(_wal_path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC,
+                 0644);
+    if (_fd < 0)
+      _throw_errno("open");
+
+    try {
+      _recover();
+    } catch (...) {
+      ::close(_fd);
+      throw;
+    }
+  }
+
+  Logged_Radix_Trie(const Logged_Radix_Trie &) = delete;
+  Logged_Radix_Trie &operator=(const Logged_Radix_Trie &) = delete;
+
+  /**
+   * @brief Commits pending log records and closes the log.
+   */
+  ~Logged_Radix_Trie() {
+    try {
+      commit();
+    } catch (...) {
+    }
+    ::close(_fd);
+  }
+
+  /**
+   * @brief Inserts a word and logs the insertion.
+   *
+   * Space complexity:  O(n); n is the length of the word.
+   * Time complexity:   O(n), n is the length of the word.
+   *
+   * @param word        The word to insert.
+   */
+  void insert(std::string_view word) {
+    _trie.insert(word);
+    _append(_op_insert, word);
+  }
+
+  /**
+   * @brief Removes a word and logs the removal if it took place.
+   *
+   * Space complexity:  O(n); n is the length of the word.
+   * Time complexity:   O(n); n is the length of the word.
+   *
+   * @param word        The string to be deleted.
+   * @return            True if deletion or deactivation was successful, else
+   *                    false.
+   */
+  bool remove(std::string_view word) {
+    if (!_trie.remove(word))
+      return false;
+    _append(_op_remove, word);
+    return true;
+  }
+
+  /**
+   * @brief Writes all buffered log records and syncs them to disk.
+   *
+   * Bytes leave the buffer as soon as they are written. If a write fails
+   * part way, for example on a full disk, the log ends in a torn record and
+   * a later commit() continues that record rather than writing it again
+   * after its first half, which would make replay drop every record behind
+   * it.
+   *
+   * @throws            std::system_error if writing fails; the records not
+   *                    written stay buffered.
+   */
+  void commit() {
+    if (_buf.empty())
+      return;
+
+    size_t written = 0;
+    try {
+      _write_all(_buf, written);
+    } catch (...) {
+      _buf.erase(0, written);
+      throw;
+    }
+    _buf.clear();
+    if (_sync && ::fdatasync(_fd) < 0)
+      _throw_errno("fdatasync");
+  }
+
+  /**
+   * @brief Writes a full snapshot and empties the log.
+   *
+   * The snapshot is written to a temporary file, synced and renamed over the
+   * previous one, and the directory is synced so the rename is durable
+   * before the log is emptied. A crash before the log is emptied is
+   * harmless: replaying the log again on the new snapshot yields the same
+   * trie.
+   *
+   * @throws            std::system_error or std::runtime_error if writing
+   *                    fails.
+   */
+  void checkpoint() {
+    commit();
+
+    std::filesystem::path tmp_path = _snapshot_path;
+    tmp_path += ".tmp";
+    _trie.save(tmp_path);
+
+    int tmp_fd = ::open(tmp_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (tmp_fd < 0)
+      _throw_errno("open");
+    int rc = ::fsync(tmp_fd);
+    int err = errno;
+    ::close(tmp_fd);
+    if (rc < 0)
+      throw std::system_error(err, std::generic_category(), "fsync");
+
+    std::filesystem::rename(tmp_path, _snapshot_path);
+    _sync_dir(_snapshot_path.parent_path());
+
+    if (::ftruncate(_fd, static_cast<off_t>(_wal_magic.size() + 1)) < 0)
+      _throw_errno("ftruncate");
+    if (_sync && ::fdatasync(_fd) < 0)
+      _throw_errno("fdatasync");
+  }
+
+  /**
+   * @brief Returns the in-memory trie for queries.
+   */
+  const Radix_Trie &trie() const { return _trie; }
+
+private:
+  static constexpr std::string_view _wal_magic = "RDXW";
+  static constexpr char _wal_version = 1;
+  static constexpr char _op_insert = 'i';
+  static constexpr char _op_remove = 'r';
+
+  Radix_Trie _trie;
+  std::filesystem::path _snapshot_path;
+  std::filesystem::path _wal_path;
+  size_t _group_bytes;
+  bool _sync;
+  std::chrono::microseconds _group_delay;
+
+  /**
+   * @brief When the oldest record in the buffer was appended.
+   */
+  std::chrono::steady_clock::time_point _group_start;
+
+  /**
+   * @brief Descriptor of the log, opened for appending.
+   */
+  int _fd = -1;
+
+  /**
+   * @brief Log records not yet written.
+   */
+  std::string _buf;
+
+  [[noreturn]] void _throw_errno(const char *what) const {
+    throw std::system_error(
+        errno, std::generic_category(),
+        std::format("{} \"{}\"", what, _wal_path.string()));
+  }
+
+  /**
+   * @brief Syncs a directory, making a rename inside it durable.
+   */
+  static void _sync_dir(const std::filesystem::path &dir) {
+    std::filesystem::path path = dir.empty() ? "." : dir;
+    int fd = ::open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0)
+      throw std::system_error(errno, std::generic_category(),
+                              std::format("open \"{}\"", path.string()));
+    int rc = ::fsync(fd);
+    int err = errno;
+    ::close(fd);
+    if (rc < 0)
+      throw std::system_error(err, std::generic_category(),
+                              std::format("fsync \"{}\"", path.string()));
+  }
+
+  /**
+   * @brief 32-bit FNV-1a checksum of a record's operation and word.
+   */
+  static uint32_t _checksum(char op, std::string_view word) {
+    uint32_t hash = 2166136261u;
+    hash = (hash ^ static_cast<unsigned char>(op)) * 16777619u;
+    for (char c : word)
+      hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+    return hash;
+  }
+
+  /**
+   * @brief Buffers a log record, committing the group once it is full or its
+   * oldest record has waited the group delay.
+   */
+  void _append(char op, std::string_view word) {
+    auto now = std::chrono::steady_clock::now();
+    if (_buf.empty())
+      _group_start = now;
+
+    _buf.push_back(op);
+    put_varint(_buf, word.size());
+    _buf.append(word);
+    uint32_t sum = _checksum(op, word);
+    for (int i = 0; i < 4; i++)
+      _buf.push_back(static_cast<char>(sum >> (8 * i)));
+
+    if (_buf.size() >= _group_bytes || now - _group_start >= _group_delay)
+      commit();
+  }
+
+  /**
+   * @brief Writes data to the log, retrying short writes.
+   *
+   * @param written     Set to the number of bytes written, also when
+   *                    writing fails.
+   */
+  void _write_all(std::string_view data, size_t &written) {
+    written = 0;
+    while (written < data.size()) {
+      ssize_t n = ::write(_fd, data.data() + written, data.size() - written);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n < 0)
+        _throw_errno("write");
+      written += static_cast<size_t>(n);
+    }
+  }
+
+  /**
+   * @brief Replays the log on top of the loaded snapshot and cuts off any
+   * torn tail. Writes the log header if the log is new.
+   */
+  void _recover() {
+    std::string log;
+    char chunk[1 << 16];
+    if (::lseek(_fd, 0, SEEK_SET) < 0)
+      _throw_errno("lseek");
+    while (true) {
+      ssize_t n = ::read(_fd, chunk, sizeof(chunk));
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n < 0)
+        _throw_errno("read");
+      if (n == 0)
+        break;
+      log.append(chunk, static_cast<size_t>(n));
+    }
+
+    size_t header_size = _wal_magic.size() + 1;
+    if (log.size() < header_size) {
+      if (::ftruncate(_fd, 0) < 0)
+        _throw_errno("ftruncate");
+      std::string header(_wal_magic);
+      header.push_back(_wal_version);
+      size_t written;
+      _write_all(header, written);
+      if (_sync && ::fdatasync(_fd) < 0)
+        _throw_errno("fdatasync");
+      return;
+    }
+
+    if (!log.starts_with(_wal_magic))
+      throw std::runtime_error(std::format(
+          "\"{}\" is not a radix trie log: bad magic.", _wal_path.string()));
+    if (log[_wal_magic.size()] != _wal_version)
+      throw std::runtime_error(
+          std::format("Unsupported radix trie log version {}.",
+                      static_cast<int>(log[_wal_magic.size()])));
+
+    const char *pos = log.data() + header_size;
+    const char *end = log.data() + log.size();
+    const char *valid_end = pos;
+    try {
+      while (pos < end) {
+        char op = *pos++;
+        uint64_t size = get_varint(pos, end);
+        auto avail = static_cast<uint64_t>(end - pos);
+        if (size > avail || avail - size < 4)
+          break;
+
+        std::string_view word(pos, size);
+        pos += size;
+        uint32_t sum = 0;
+        for (int i = 0; i < 4; i++)
+          sum |= static_cast<uint32_t>(static_cast<unsigned char>(*pos++))
+                 << (8 * i);
+        if (sum != _checksum(op, word))
+          break;
+
+        if (op == _op_insert)
+          _trie.insert(word);
+        else if (op == _op_remove)
+          _trie.remove(word);
+        else
+          break;
+        valid_end = pos;
+      }
+    } catch (const std::runtime_error &) {
+      // A truncated varint marks a torn tail, like any other bad record.
+    }
+
+    if (valid_end != end &&
+        ::ftruncate(_fd, static_cast<off_t>(valid_end - log.data())) < 0)
+      _throw_errno("ftruncate");
+  }
+};
+
+} // namespace radix_trie
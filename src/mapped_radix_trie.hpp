@@ -0,0 +1,495 @@
+/**
+ * @file        mapped_radix_trie.hpp
+ * @brief       Read-only radix trie queried in place from a flat image.
+ *
+ * @details     Contains the writer of the flat on-disk layout and a reader
+ *              that memory-maps it and answers queries without parsing it.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#pragma once
+
+#include "radix_trie.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace radix_trie {
+
+/**
+ * @brief An immutable Radix Trie stored as one flat, position-independent
+ * image.
+ *
+ * The image starts with a 16-byte header: magic "RDXM", a version, the
+ * offset of the root node and a reserved word. Every node is a 4-byte aligned
+ * record of
+ *  - u32 label length,
+ *  - u32 child count shifted left by one, with the word flag in the lowest
+ *    bit,
+ *  - u32 offset of each child,
+ *  - u8 first byte of each child's label, in ascending order,
+ *  - the label bytes, padded to 4 bytes.
+ *
+ * All integers are little-endian and all offsets are counted in 4-byte units
+ * from the start of the image, so no pointer is ever stored and images up to
+ * 16 GiB can be mapped anywhere. Nodes are laid out in preorder with children
+ * sorted, so completions come out in lexicographic order. Preorder also puts
+ * every child after its parent; queries check this on each step down, so a
+ * corrupt image cannot make them loop.
+ */
+class Mapped_Radix_Trie {
+public:
+  /**
+   * @brief Memory-maps an image file written by write().
+   *
+   * Space complexity:  O(1).
+   * Time complexity:   O(1).
+   *
+   * @param path        The image file to map.
+   * @throws            std::system_error if the file cannot be mapped,
+   *                    std::runtime_error if it is not a valid image.
+   */
+  explicit Mapped_Radix_Trie(const std::filesystem::path &path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      throw std::system_error(
+          errno, std::generic_category(),
+          std::format("Failed to open \"{}\"", path.string()));
+
+    struct stat st;
+    if (::fstat(fd, &st) < 0) {
+      int err = errno;
+      ::close(fd);
+      throw std::system_error(err, std::generic_category(),
+                              std::format("Failed to stat \"{}\"",
+                                          path.string()));
+    }
+
+    _map_size = static_cast<size_t>(st.st_size);
+    if (_map_size < _header_size) {
+      ::close(fd);
+      throw std::runtime_error(std::format(
+          "\"{}\" is too small to be a radix trie image.", path.string()));
+    }
+
+    void *map = ::mmap(nullptr, _map_size, PROT_READ, MAP_SHARED, fd, 0);
+    int err = errno;
+    ::close(fd);
+    if (map == MAP_FAILED)
+      throw std::system_error(err, std::generic_category(),
+                              std::format("Failed to map \"{}\"",
+                                          path.string()));
+
+    _map = map;
+    _data = static_cast<const unsigned char *>(map);
+    _size = _map_size;
+    _validate();
+  }
+
+  /**
+   * @brief Wraps an image that is already in memory. The memory is not owned
+   * and must outlive this object.
+   *
+   * @param image       The image bytes.
+   * @throws            std::runtime_error if it is not a valid image.
+   */
+  explicit Mapped_Radix_Trie(std::span<const std::byte> image)
+      : _data(reinterpret_cast<const unsigned char *>(image.data())),
+        _size(image.size()) {
+    _validate();
+  }
+
+  Mapped_Radix_Trie(const Mapped_Radix_Trie &) = delete;
+  Mapped_Radix_Trie &operator=(const Mapped_Radix_Trie &) = delete;
+
+  Mapped_Radix_Trie(Mapped_Radix_Trie &&other) noexcept
+      : _data(std::exchange(other._data, nullptr)),
+        _size(std::exchange(other._size, 0)), _root(other._root),
+        _map(std::exchange(other._map, nullptr)),
+        _map_size(std::exchange(other._map_size, 0)) {}
+
+  Mapped_Radix_Trie &operator=(Mapped_Radix_Trie &&other) noexcept {
+    if (this != &other) {
+      _unmap();
+      _data = std::exchange(other._data, nullptr);
+      _size = std::exchange(other._size, 0);
+      _root = other._root;
+      _map = std::exchange(other._map, nullptr);
+      _map_size = std::exchange(other._map_size, 0);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Unmaps the image, if this object mapped it.
+   */
+  ~Mapped_Radix_Trie() { _unmap(); }
+
+  /**
+   * @brief Writes a trie as an image that can be mapped by this class.
+   *
+   * Space complexity:  O(s); s is the size of the image.
+   * Time complexity:   O(n log k); n is the number of nodes, k is the
+   *                    largest fanout.
+   *
+   * @param trie        The trie to write.
+   * @param os          The stream to write to.
+   * @throws            std::runtime_error if the image would exceed 16 GiB
+   *                    or writing fails.
+   */
+  static void write(const Radix_Trie &trie, std::ostream &os) {
+    std::string buf;
+    buf.append(_magic);
+    _put_u32(buf, _version);
+    _put_u32(buf, _header_size / 4);
+    _put_u32(buf, 0);
+
+    // Each frame is a node and the position of the slot that must receive
+    // its offset, 0 for the root.
+    std::vector<std::pair<const Radix_Node *, size_t>> stack{{trie.root(), 0}};
+    std::vector<const Radix_Node *> children;
+    while (!stack.empty()) {
+      auto [curr, slot] = stack.back();
+      stack.pop_back();
+
+      size_t offset = buf.size();
+      if (offset / 4 > UINT32_MAX)
+        throw std::runtime_error("Radix trie image exceeds 16 GiB.");
+      if (slot)
+        _set_u32(buf, slot, static_cast<uint32_t>(offset / 4));
+
+      children.clear();
+      for (const auto &entry : curr->children)
+        children.push_back(entry.second);
+      std::ranges::sort(children, {}, [](const Radix_Node *child) {
+        return static_cast<unsigned char>(child->val[0]);
+      });
+
+      _put_u32(buf, static_cast<uint32_t>(curr->val.size()));
+      _put_u32(buf, static_cast<uint32_t>(children.size() << 1) |
+                        curr->is_word);
+      size_t slots = buf.size();
+      buf.append(4 * children.size(), '\0');
+      for (const Radix_Node *child : children)
+        buf.push_back(child->val[0]);
+      buf += curr->val;
+      buf.append((4 - buf.size() % 4) % 4, '\0');
+
+      for (size_t i = children.size(); i-- > 0;)
+        stack.emplace_back(children[i], slots + 4 * i);
+    }
+
+    os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+    if (!os)
+      throw std::runtime_error("Failed to write radix trie image.");
+  }
+
+  /**
+   * @brief Writes a trie as an image file. See write(const Radix_Trie &,
+   * std::ostream &).
+   *
+   * @param trie        The trie to write.
+   * @param path        The file to write to. It is overwritten.
+   * @throws            std::runtime_error if the file cannot be written.
+   */
+  static void write(const Radix_Trie &trie,
+                    const std::filesystem::path &path) {
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    if (!os)
+      throw std::runtime_error(
+          std::format("Failed to open \"{}\" for writing.", path.string()));
+    write(trie, os);
+  }
+
+  /**
+   * @brief Checks whether a word is stored. Does not allocate.
+   *
+   * Space complexity:  O(1).
+   * Time complexity:   O(n log k); n is the length of the word, k is the
+   *                    largest fanout.
+   *
+   * @param word        The word to search for.
+   * @return            True if the word is stored, else false.
+   */
+  bool contains(std::string_view word) const {
+    _Node curr = _node(_root);
+    size_t w_idx = 0;
+
+    while (w_idx < word.size()) {
+      auto child = _child(curr, word[w_idx]);
+      if (!child)
+        return false;
+
+      curr = _node(*child);
+      if (curr.label.size() > word.size() - w_idx ||
+          word.substr(w_idx, curr.label.size()) != curr.label)
+        return false;
+      w_idx += curr.label.size();
+    }
+
+    return curr.is_word;
+  }
+
+  /**
+   * @brief Finds the longest stored word that is a prefix of a key. Does not
+   * allocate.
+   *
+   * Space complexity:  O(1).
+   * Time complexity:   O(n log k); n is the length of the key, k is the
+   *                    largest fanout.
+   *
+   * @param key         The key to match.
+   * @return            Length of the longest stored word that prefixes the
+   *                    key, or std::nullopt if there is none.
+   */
+  std::optional<size_t> longest_prefix(std::string_view key) const {
+    _Node curr = _node(_root);
+    size_t k_idx = 0;
+    std::optional<size_t> longest;
+    if (curr.is_word)
+      longest = 0;
+
+    while (k_idx < key.size()) {
+      auto child = _child(curr, key[k_idx]);
+      if (!child)
+        break;
+
+      curr = _node(*child);
+      if (curr.label.size() > key.size() - k_idx ||
+          key.substr(k_idx, curr.label.size()) != curr.label)
+        break;
+
+      k_idx += curr.label.size();
+      if (curr.is_word)
+        longest = k_idx;
+    }
+
+    return longest;
+  }
+
+  /**
+   * @brief Finds all completions for a given prefix that form a word, in
+   * lexicographic order. Like Radix_Trie::complete(), the completions are
+   * the remainders after the prefix, and the prefix itself is not included.
+   *
+   * Space complexity:  O(n); n is the size of the out_vec.
+   * Time complexity:   O(n*h); n is the size of the prefix, h is number of
+   *                    nodes in the relevant subtree.
+   *
+   * @param pref        A string that needs to be completed.
+   * @param out_vec     A vector of strings that should be populated with
+   *                    completions.
+   */
+  void complete(std::string_view pref,
+                std::vector<std::string> &out_vec) const {
+    uint32_t curr_off = _root;
+    size_t pref_idx = 0;
+    std::string base;
+
+    while (pref_idx < pref.size()) {
+      auto child = _child(_node(curr_off), pref[pref_idx]);
+      if (!child)
+        return;
+
+      curr_off = *child;
+      std::string_view label = _node(curr_off).label;
+      size_t match_len = std::min(label.size(), pref.size() - pref_idx);
+      if (label.substr(0, match_len) != pref.substr(pref_idx, match_len))
+        return;
+
+      pref_idx += match_len;
+      if (match_len < label.size())
+        base = label.substr(match_len);
+    }
+
+    // Each frame is a node and the base length before its label is added.
+    std::vector<std::pair<uint32_t, size_t>> stack;
+    _Node start = _node(curr_off);
+    if (start.is_word && !base.empty())
+      out_vec.push_back(base);
+    for (size_t i = start.n_children; i-- > 0;)
+      stack.emplace_back(_child_at(start, i), base.size());
+
+    while (!stack.empty()) {
+      auto [off, base_size] = stack.back();
+      stack.pop_back();
+
+      _Node curr = _node(off);
+      base.resize(base_size);
+      base += curr.label;
+      if (curr.is_word)
+        out_vec.push_back(base);
+      for (size_t i = curr.n_children; i-- > 0;)
+        stack.emplace_back(_child_at(curr, i), base.size());
+    }
+  }
+
+  /**
+   * @brief Returns the raw image bytes.
+   */
+  std::span<const std::byte> image() const {
+    return {reinterpret_cast<const std::byte *>(_data), _size};
+  }
+
+private:
+  /**
+   * @brief A decoded view of a node record inside the image.
+   */
+  struct _Node {
+    uint32_t off;
+    std::string_view label;
+    const unsigned char *offsets;
+    const unsigned char *keys;
+    uint32_t n_children;
+    bool is_word;
+  };
+
+  static constexpr std::string_view _magic = "RDXM";
+  static constexpr uint32_t _version = 1;
+  static constexpr size_t _header_size = 16;
+
+  /**
+   * @brief Start and size of the image.
+   */
+  const unsigned char *_data = nullptr;
+  size_t _size = 0;
+
+  /**
+   * @brief Offset of the root node, in 4-byte units.
+   */
+  uint32_t _root = 0;
+
+  /**
+   * @brief The mapping owned by this object, nullptr if not owned.
+   */
+  void *_map = nullptr;
+  size_t _map_size = 0;
+
+  static void _put_u32(std::string &out, uint32_t val) {
+    for (int i = 0; i < 4; i++)
+      out.push_back(static_cast<char>(val >> (8 * i)));
+  }
+
+  static void _set_u32(std::string &out, size_t pos, uint32_t val) {
+    for (int i = 0; i < 4; i++)
+      out[pos + i] = static_cast<char>(val >> (8 * i));
+  }
+
+  static uint32_t _get_u32(const unsigned char *pos) {
+    uint32_t val;
+    std::memcpy(&val, pos, sizeof(val));
+    if constexpr (std::endian::native == std::endian::big)
+      val = std::byteswap(val);
+    return val;
+  }
+
+  void _unmap() {
+    if (_map)
+      ::munmap(_map, _map_size);
+    _map = nullptr;
+  }
+
+  /**
+   * @brief Checks the header and the root record. The other records are
+   * checked as queries reach them, by _node() and _child_at(), so mapping
+   * stays O(1) and never touches pages no query needs.
+   *
+   * @throws            std::runtime_error if the image is not valid.
+   */
+  void _validate() {
+    if (_size < _header_size ||
+        std::string_view(reinterpret_cast<const char *>(_data),
+                         _magic.size()) != _magic)
+      throw std::runtime_error("Not a radix trie image: bad magic.");
+
+    uint32_t version = _get_u32(_data + 4);
+    if (version != _version)
+      throw std::runtime_error(
+          std::format("Unsupported radix trie image version {}.", version));
+
+    _root = _get_u32(_data + 8);
+    _node(_root);
+  }
+
+  /**
+   * @brief Decodes the node record at a given offset.
+   *
+   * @param off         Offset of the record, in 4-byte units.
+   * @return            A view of the record.
+   * @throws            std::runtime_error if the record lies outside the
+   *                    image.
+   */
+  _Node _node(uint32_t off) const {
+    size_t pos = size_t{off} * 4;
+    if (pos < _header_size || pos + 8 > _size)
+      throw std::runtime_error("Corrupt radix trie image: bad node offset.");
+
+    uint32_t label_size = _get_u32(_data + pos);
+    uint32_t meta = _get_u32(_data + pos + 4);
+    uint32_t n_children = meta >> 1;
+    size_t label_pos = pos + 8 + 5 * size_t{n_children};
+    if (n_children > 256 || label_pos + label_size > _size)
+      throw std::runtime_error("Corrupt radix trie image: bad node record.");
+
+    return {off,
+            {reinterpret_cast<const char *>(_data + label_pos), label_size},
+            _data + pos + 8,
+            _data + pos + 8 + 4 * size_t{n_children},
+            n_children,
+            static_cast<bool>(meta & 1)};
+  }
+
+  /**
+   * @brief Returns the offset of the i-th child of a node.
+   *
+   * @throws            std::runtime_error if the child does not lie after
+   *                    its parent, which would let a walk revisit a node.
+   */
+  static uint32_t _child_at(const _Node &node, size_t i) {
+    uint32_t child = _get_u32(node.offsets + 4 * i);
+    if (child <= node.off)
+      throw std::runtime_error(
+          "Corrupt radix trie image: child before its parent.");
+    return child;
+  }
+
+  /**
+   * @brief Finds the child whose label starts with a given byte.
+   *
+   * @param node        The parent node.
+   * @param c           First byte of the child label.
+   * @return            Offset of the child, or std::nullopt if there is none.
+   */
+  static std::optional<uint32_t> _child(const _Node &node, char c) {
+    const unsigned char *end = node.keys + node.n_children;
+    auto key = static_cast<unsigned char>(c);
+    const unsigned char *it = std::lower_bound(node.keys, end, key);
+    if (it == end || *it != key)
+      return {};
+    return _child_at(node, static_cast<size_t>(it - node.keys));
+  }
+};
+
+} // namespace radix_trie
@@ -0,0 +1,118 @@
+/**
+ * @file        mismatch.hpp
+ * @brief       Vectorized search for the first differing byte.
+ *
+ * @details     Compares edge labels against keys 8, 16 or 32 bytes per step.
+ *              On x86 the AVX2 path is picked at runtime when the CPU
+ *              supports it, with SSE2 as the baseline; elsewhere, or with
+ *              RADIX_TRIE_NO_SIMD defined, 8-byte words are compared.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if !defined(RADIX_TRIE_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define RADIX_TRIE_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace radix_trie {
+
+namespace detail {
+
+/**
+ * @brief Compares 8-byte words, then the remaining bytes one by one.
+ */
+inline size_t mismatch_scalar(const char *a, const char *b, size_t n) {
+  size_t i = 0;
+  if constexpr (std::endian::native == std::endian::little) {
+    for (; i + 8 <= n; i += 8) {
+      uint64_t x, y;
+      std::memcpy(&x, a + i, 8);
+      std::memcpy(&y, b + i, 8);
+      if (x != y)
+        return i + static_cast<size_t>(std::countr_zero(x ^ y)) / 8;
+    }
+  }
+  while (i < n && a[i] == b[i])
+    i++;
+  return i;
+}
+
+#ifdef RADIX_TRIE_X86_SIMD
+
+[[gnu::target("sse2")]] inline size_t mismatch_sse2(const char *a,
+                                                    const char *b, size_t n) {
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+    __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+    auto equal = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)));
+    if (equal != 0xffff)
+      return i + static_cast<size_t>(std::countr_one(equal));
+  }
+  return i + mismatch_scalar(a + i, b + i, n - i);
+}
+
+[[gnu::target("avx2")]] inline size_t mismatch_avx2(const char *a,
+                                                    const char *b, size_t n) {
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+    auto equal =
+        static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+    if (equal != 0xffffffff)
+      return i + static_cast<size_t>(std::countr_one(equal));
+  }
+  return i + mismatch_sse2(a + i, b + i, n - i);
+}
+
+/**
+ * @brief The widest implementation the CPU supports, resolved once.
+ */
+inline size_t (*const mismatch_wide)(const char *, const char *, size_t) =
+    [] {
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2") ? mismatch_avx2 : mismatch_sse2;
+    }();
+
+#endif
+
+/**
+ * @brief Inputs shorter than this are compared inline, since a call through
+ * the dispatch pointer costs more than it saves.
+ */
+inline constexpr size_t mismatch_wide_min = 16;
+
+} // namespace detail
+
+/**
+ * @brief Finds the first position at which two byte ranges differ.
+ *
+ * Space complexity:  O(1).
+ * Time complexity:   O(n/w); n is the length, w is the vector width.
+ *
+ * @param a     The first range.
+ * @param b     The second range.
+ * @param n     Number of bytes to compare. Both ranges must hold this many.
+ * @return      Index of the first differing byte, or n if none differs.
+ */
+inline size_t mismatch(const char *a, const char *b, size_t n) {
+#ifdef RADIX_TRIE_X86_SIMD
+  if (n >= detail::mismatch_wide_min)
+    return detail::mismatch_wide(a, b, n);
+#endif
+  return detail::mismatch_scalar(a, b, n);
+}
+
+} // namespace radix_trie
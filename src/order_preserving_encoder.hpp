@@ -0,0 +1,342 @@
+/**
+ * @file        order_preserving_encoder.hpp
+ * @brief       Order-preserving key compression in the style of HOPE.
+ *
+ * @details     Maps keys to shorter byte strings that sort in the same order,
+ *              using a dictionary of frequent substrings trained on a sample
+ *              of keys.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <ranges>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace radix_trie {
+
+/**
+ * @brief An order-preserving string compressor: for any keys a < b,
+ * encode(a) < encode(b), comparing bytes as unsigned.
+ *
+ * The string space is cut into sorted intervals at every single byte and at
+ * every dictionary gram g, together with the first string past all strings
+ * starting with g. Each interval has a symbol, the longest prefix shared by
+ * all of its strings. A key is encoded by repeatedly finding the interval of
+ * its remaining bytes, emitting the interval's code and dropping the
+ * interval's symbol, so frequent grams are consumed whole.
+ *
+ * Codes are one or two bytes, assigned in interval order, so they sort like
+ * the intervals and no code is a prefix of another. The intervals most used
+ * on the sample get a lead byte to themselves; runs of the others share a
+ * lead byte and are told apart by a second byte.
+ *
+ * Encodings sort like their keys but do not share their prefixes: the
+ * strings starting with a prefix p encode to the range [encode(p),
+ * encode(successor(p))).
+ */
+class Order_Preserving_Encoder {
+public:
+  /**
+   * @brief Trains an encoder on a sample of keys.
+   *
+   * Every gram of 2 to max_gram bytes in the sample is scored by its count
+   * times the bytes it saves, and the best n_grams of them make up the
+   * dictionary.
+   *
+   * Space complexity:  O(s*m); s is the size of the sample in bytes, m is
+   *                    max_gram.
+   * Time complexity:   O(s*m + g*log(g)); g is the number of distinct grams.
+   *
+   * @param sample      The keys to train on.
+   * @param n_grams     Number of dictionary grams. Default is 1024.
+   * @param max_gram    Length of the longest gram, at least 2. Default is 4.
+   * @throws            std::invalid_argument if max_gram is less than 2 or
+   *                    n_grams is more than 32640.
+   */
+  template <std::ranges::input_range R>
+    requires std::convertible_to<std::ranges::range_reference_t<R>,
+                                 std::string_view>
+  explicit Order_Preserving_Encoder(const R &sample, size_t n_grams = 1024,
+                                    size_t max_gram = 4) {
+    if (max_gram < 2)
+      throw std::invalid_argument(std::format(
+          "Invalid max gram length {}. It must be at least 2.", max_gram));
+    if (n_grams > _max_grams)
+      throw std::invalid_argument(std::format(
+          "Invalid number of grams {}. It must be at most {}.", n_grams,
+          _max_grams));
+
+    std::unordered_map<std::string, size_t> counts;
+    for (std::string_view key : sample)
+      for (size_t i = 0; i < key.size(); i++)
+        for (size_t len = 2; len <= max_gram && i + len <= key.size(); len++)
+          counts[std::string(key.substr(i, len))]++;
+
+    std::vector<std::pair<size_t, std::string>> scored;
+    scored.reserve(counts.size());
+    for (auto &[gram, count] : counts)
+      scored.emplace_back(count * (gram.size() - 1), gram);
+    n_grams = std::min(n_grams, scored.size());
+    std::ranges::partial_sort(scored, scored.begin() + n_grams,
+                              std::ranges::greater());
+
+    std::set<std::string> bounds;
+    for (size_t c = 0; c < 256; c++)
+      bounds.insert(std::string(1, static_cast<char>(c)));
+    for (size_t i = 0; i < n_grams; i++) {
+      bounds.insert(scored[i].second);
+      if (auto next = successor(scored[i].second))
+        bounds.insert(*next);
+    }
+    _bounds.assign(bounds.begin(), bounds.end());
+    _index_bounds();
+    _find_symbols();
+
+    std::vector<size_t> usage(_bounds.size());
+    for (std::string_view key : sample)
+      while (!key.empty()) {
+        size_t idx = _interval(key);
+        usage[idx]++;
+        key.remove_prefix(_symbols[idx].size());
+      }
+    _assign_codes(usage);
+  }
+
+  /**
+   * @brief Encodes a key.
+   *
+   * Space complexity:  O(n); n is the length of the key.
+   * Time complexity:   O(n*log(d)); d is the number of dictionary grams.
+   *
+   * @param key         The key to encode.
+   * @return            The encoded key.
+   */
+  std::string encode(std::string_view key) const {
+    std::string out;
+    out.reserve(key.size());
+    while (!key.empty()) {
+      size_t idx = _interval(key);
+      const _Code &code = _codes[idx];
+      out.push_back(static_cast<char>(code.lead));
+      if (code.wide)
+        out.push_back(static_cast<char>(code.second));
+      key.remove_prefix(_symbols[idx].size());
+    }
+    return out;
+  }
+
+  /**
+   * @brief Decodes an encoded key.
+   *
+   * Space complexity:  O(n); n is the length of the decoded key.
+   * Time complexity:   O(n).
+   *
+   * @param code        The encoded key.
+   * @return            The original key.
+   * @throws            std::invalid_argument if the input is not a sequence
+   *                    of codes.
+   */
+  std::string decode(std::string_view code) const {
+    std::string out;
+    out.reserve(2 * code.size());
+    for (size_t pos = 0; pos < code.size();) {
+      const _Lead &lead = _leads[static_cast<uint8_t>(code[pos++])];
+      size_t idx = lead.first;
+      if (lead.count == 0)
+        throw std::invalid_argument(std::format(
+            "Invalid code: unused lead byte at offset {}.", pos - 1));
+      if (lead.wide) {
+        if (pos == code.size() ||
+            static_cast<uint8_t>(code[pos]) >= lead.count)
+          throw std::invalid_argument(std::format(
+              "Invalid code: bad second byte at offset {}.", pos));
+        idx += static_cast<uint8_t>(code[pos++]);
+      }
+      out += _symbols[idx];
+    }
+    return out;
+  }
+
+  /**
+   * @brief Returns the smallest string greater than every string that
+   * starts with a prefix, or std::nullopt if there is none (the prefix is
+   * empty or all 0xff bytes).
+   *
+   * @param prefix      The prefix.
+   * @return            The successor of the prefix.
+   */
+  static std::optional<std::string> successor(std::string_view prefix) {
+    std::string next(prefix);
+    while (!next.empty() && static_cast<uint8_t>(next.back()) == 0xff)
+      next.pop_back();
+    if (next.empty())
+      return {};
+    next.back() = static_cast<char>(static_cast<uint8_t>(next.back()) + 1);
+    return next;
+  }
+
+  /**
+   * @brief Returns the number of intervals, and so of distinct codes.
+   */
+  size_t n_symbols() const { return _symbols.size(); }
+
+private:
+  /**
+   * @brief The code of an interval: a lead byte, and if wide, a second byte.
+   */
+  struct _Code {
+    uint8_t lead;
+    uint8_t second;
+    bool wide;
+  };
+
+  /**
+   * @brief The intervals sharing a lead byte: the first of them and their
+   * count. A lead byte of a single interval is one-byte unless wide.
+   */
+  struct _Lead {
+    size_t first = 0;
+    size_t count = 0;
+    bool wide = false;
+  };
+
+  /**
+   * @brief Largest dictionary that still fits every interval into two-byte
+   * codes.
+   */
+  static constexpr size_t _max_grams = (65536 - 256) / 2;
+
+  /**
+   * @brief Sorted lower bounds of the intervals.
+   */
+  std::vector<std::string> _bounds;
+
+  /**
+   * @brief Symbol and code of each interval.
+   */
+  std::vector<std::string> _symbols;
+  std::vector<_Code> _codes;
+
+  /**
+   * @brief Intervals by lead byte, for decoding.
+   */
+  std::array<_Lead, 256> _leads{};
+
+  /**
+   * @brief Index of the first bound starting with each byte, and past the
+   * last.
+   */
+  std::array<size_t, 257> _first_bound{};
+
+  void _index_bounds() {
+    size_t idx = 0;
+    for (size_t c = 0; c < 256; c++) {
+      _first_bound[c] = idx;
+      while (idx < _bounds.size() &&
+             static_cast<uint8_t>(_bounds[idx][0]) == c)
+        idx++;
+    }
+    _first_bound[256] = idx;
+  }
+
+  /**
+   * @brief Finds the symbol of every interval: the longest prefix x of its
+   * lower bound such that the interval ends at or before successor(x).
+   */
+  void _find_symbols() {
+    _symbols.resize(_bounds.size());
+    for (size_t i = 0; i < _bounds.size(); i++) {
+      std::string_view bound = _bounds[i];
+      for (size_t len = bound.size(); len > 0; len--) {
+        auto next = successor(bound.substr(0, len));
+        if (i + 1 == _bounds.size() ? !next : !next || *next >= _bounds[i + 1]) {
+          _symbols[i] = bound.substr(0, len);
+          break;
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Finds the interval holding a non-empty string.
+   */
+  size_t _interval(std::string_view key) const {
+    auto c = static_cast<uint8_t>(key[0]);
+    auto begin = _bounds.begin() + static_cast<ptrdiff_t>(_first_bound[c]);
+    auto end = _bounds.begin() + static_cast<ptrdiff_t>(_first_bound[c + 1]);
+    auto it = std::upper_bound(
+        begin, end, key,
+        [](std::string_view k, const std::string &b) { return k < b; });
+    return static_cast<size_t>(it - _bounds.begin()) - 1;
+  }
+
+  /**
+   * @brief Gives one-byte codes to as many of the most used intervals as fit
+   * in 256 lead bytes, and two-byte codes to the rest.
+   *
+   * Taking an interval out of a run of two-byte intervals costs its own lead
+   * byte and may change how many lead bytes the rest of the run needs, so
+   * each candidate is checked against its neighbours among the one-byte
+   * intervals.
+   */
+  void _assign_codes(const std::vector<size_t> &usage) {
+    size_t n = _bounds.size();
+    auto chunks = [](size_t len) { return (len + 255) / 256; };
+
+    std::vector<size_t> by_usage(n);
+    for (size_t i = 0; i < n; i++)
+      by_usage[i] = i;
+    std::ranges::stable_sort(by_usage, std::ranges::greater(),
+                             [&usage](size_t i) { return usage[i]; });
+
+    std::set<size_t> narrow;
+    size_t leads = chunks(n);
+    for (size_t idx : by_usage) {
+      auto next = narrow.upper_bound(idx);
+      size_t hi = next == narrow.end() ? n : *next;
+      size_t lo = next == narrow.begin() ? 0 : *std::prev(next) + 1;
+      size_t with = leads + 1 + chunks(idx - lo) + chunks(hi - idx - 1) -
+                    chunks(hi - lo);
+      if (with > 256)
+        continue;
+      narrow.insert(idx);
+      leads = with;
+    }
+
+    _codes.resize(n);
+    size_t lead = 0;
+    for (size_t i = 0; i < n;) {
+      if (narrow.contains(i)) {
+        _codes[i] = {static_cast<uint8_t>(lead), 0, false};
+        _leads[lead++] = {i, 1, false};
+        i++;
+        continue;
+      }
+
+      size_t first = i;
+      while (i < n && i - first < 256 && !narrow.contains(i)) {
+        _codes[i] = {static_cast<uint8_t>(lead),
+                     static_cast<uint8_t>(i - first), true};
+        i++;
+      }
+      _leads[lead++] = {first, i - first, true};
+    }
+  }
+};
+
+} // namespace radix_trie
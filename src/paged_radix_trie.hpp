@@ -0,0 +1,1026 @@
+/**
+ * @file        paged_radix_trie.hpp
+ * @brief       Disk-backed radix trie paged through a bounded buffer pool.
+ *
+ * @details     Contains the writers of the paged file layout, from a trie in
+ *              memory or streamed from sorted keys, and a reader that keeps
+ *              the top levels of the trie pinned in memory and loads the
+ *              pages below them on demand, evicting with the CLOCK policy.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#pragma once
+
+#include "radix_trie.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace radix_trie {
+
+/**
+ * @brief An immutable Radix Trie stored in fixed-size pages on disk, for key
+ * sets larger than memory.
+ *
+ * Nodes above the pin depth are stored in a contiguous region that is read
+ * once and stays in memory. Below it, a subtree that fits into a page is
+ * stored whole, and small subtrees share pages. A larger subtree is packed
+ * breadth-first from its top, so a lookup reads about one page per page-sized
+ * slice of the trie it crosses. Pages are cached in a buffer pool with a
+ * fixed number of frames and CLOCK eviction.
+ *
+ * The file is a sequence of pages. Page 0 holds the header: magic "RDXP", a
+ * version, the page size, the first and the number of pinned pages and the
+ * total page count, all 32-bit little-endian. A node is a record of
+ *  - u32 label length,
+ *  - u32 child count shifted left by one, with the word flag in the lowest
+ *    bit,
+ *  - u64 reference of each child, the page number in the high and the byte
+ *    offset within the page in the low 32 bits,
+ *  - u8 first byte of each child's label, in ascending order,
+ *  - the label bytes.
+ * The root is the first record of the pinned region, which write() puts
+ * right after the header and write_sorted() after the data pages. Records
+ * never straddle data pages, so a node must fit into one page.
+ *
+ * The reader is not thread-safe, since queries update the buffer pool.
+ */
+class Paged_Radix_Trie {
+public:
+  /**
+   * @brief Opens a paged trie file written by write().
+   *
+   * Space complexity:  O(p + f*s); p is the size of the pinned region, f is
+   *                    the number of frames, s is the page size.
+   * Time complexity:   O(p); p is the size of the pinned region.
+   *
+   * @param path        The file to open.
+   * @param n_frames    Number of pages the buffer pool holds. Default is 1024.
+   * @throws            std::system_error if the file cannot be read,
+   *                    std::runtime_error if it is not a valid paged trie.
+   */
+  explicit Paged_Radix_Trie(const std::filesystem::path &path,
+                            size_t n_frames = 1024)
+      : _path(path), _n_frames(std::max<size_t>(n_frames, 1)) {
+    _fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (_fd < 0)
+      _throw_errno("open");
+
+    try {
+      char header[_header_size];
+      _read_at(header, sizeof(header), 0);
+      if (std::string_view(header, _magic.size()) != _magic)
+        throw std::runtime_error(std::format(
+            "\"{}\" is not a paged radix trie: bad magic.", path.string()));
+
+      uint32_t version = _get_u32(header + 4);
+      if (version != _version)
+        throw std::runtime_error(std::format(
+            "Unsupported paged radix trie version {}.", version));
+
+      _page_size = _get_u32(header + 8);
+      _pinned_first = _get_u32(header + 12);
+      uint32_t n_pinned = _get_u32(header + 16);
+      _n_pages = _get_u32(header + 20);
+      if (_page_size < _header_size || n_pinned == 0 ||
+          _pinned_first + n_pinned > _n_pages)
+        throw std::runtime_error("Corrupt paged radix trie: bad header.");
+
+      _pinned.resize(size_t{n_pinned} * _page_size);
+      _read_at(_pinned.data(), _pinned.size(),
+               size_t{_pinned_first} * _page_size);
+      _pinned_end = _pinned_first + n_pinned;
+    } catch (...) {
+      ::close(_fd);
+      throw;
+    }
+  }
+
+  Paged_Radix_Trie(const Paged_Radix_Trie &) = delete;
+  Paged_Radix_Trie &operator=(const Paged_Radix_Trie &) = delete;
+
+  /**
+   * @brief Closes the file.
+   */
+  ~Paged_Radix_Trie() { ::close(_fd); }
+
+  /**
+   * @brief Writes a trie in the paged layout.
+   *
+   * Space complexity:  O(n); n is the number of nodes.
+   * Time complexity:   O(n log k); n is the number of nodes, k is the
+   *                    largest fanout.
+   *
+   * @param trie        The trie to write.
+   * @param path        The file to write to. It is overwritten.
+   * @param page_size   Size of a page in bytes. Default is 4096.
+   * @param pin_depth   Number of trie levels, starting at the root, that
+   *                    are kept in memory. At least the root is. Default is 2.
+   * @throws            std::invalid_argument if a node does not fit into a
+   *                    page, std::runtime_error if writing fails.
+   */
+  static void write(const Radix_Trie &trie, const std::filesystem::path &path,
+                    size_t page_size = 4096, size_t pin_depth = 2) {
+    if (page_size < _header_size || page_size > UINT32_MAX)
+      throw std::invalid_argument(
+          std::format("Invalid page size {}.", page_size));
+    pin_depth = std::max<size_t>(pin_depth, 1);
+
+    std::unordered_map<const Radix_Node *, uint64_t> refs;
+    std::vector<std::vector<const Radix_Node *>> pages;
+
+    // Pinned region: every node above the pin depth, laid out contiguously
+    // from page 1 on. Nodes at the pin depth start the paged subtrees.
+    std::deque<const Radix_Node *> roots;
+    std::vector<const Radix_Node *> pinned;
+    uint64_t pinned_size = 0;
+    std::vector<std::pair<const Radix_Node *, size_t>> stack{{trie.root(), 0}};
+    while (!stack.empty()) {
+      auto [curr, depth] = stack.back();
+      stack.pop_back();
+      if (depth == pin_depth) {
+        roots.push_back(curr);
+        continue;
+      }
+
+      uint64_t page = 1 + pinned_size / page_size;
+      refs[curr] = (page << 32) | (pinned_size % page_size);
+      pinned.push_back(curr);
+      pinned_size += _record_size(curr);
+      std::vector<const Radix_Node *> children = _sorted_children(curr);
+      for (size_t i = children.size(); i-- > 0;)
+        stack.emplace_back(children[i], depth + 1);
+    }
+    uint64_t n_pinned = std::max<uint64_t>(
+        1, (pinned_size + page_size - 1) / page_size);
+
+    // Data pages. A subtree that fits into a page is stored whole, sharing a
+    // page with other small subtrees. A larger one fills a fresh page
+    // breadth-first from its root, and the nodes left over start subtrees
+    // of their own.
+    std::unordered_map<const Radix_Node *, size_t> sizes;
+    for (const Radix_Node *root : roots)
+      _subtree_sizes(root, page_size, sizes);
+
+    size_t shared_page = SIZE_MAX;
+    size_t shared_used = 0;
+    auto place = [&](const Radix_Node *node, size_t page, size_t &used) {
+      refs[node] = (uint64_t{1 + n_pinned + page} << 32) | used;
+      pages[page].push_back(node);
+      used += _record_size(node);
+    };
+
+    while (!roots.empty()) {
+      const Radix_Node *root = roots.front();
+      roots.pop_front();
+
+      if (sizes.at(root) <= page_size) {
+        if (shared_page == SIZE_MAX || shared_used + sizes[root] > page_size) {
+          shared_page = pages.size();
+          shared_used = 0;
+          pages.emplace_back();
+        }
+        std::vector<const Radix_Node *> subtree{root};
+        while (!subtree.empty()) {
+          const Radix_Node *curr = subtree.back();
+          subtree.pop_back();
+          place(curr, shared_page, shared_used);
+          for (const auto &entry : curr->children)
+            subtree.push_back(entry.second);
+        }
+        continue;
+      }
+
+      size_t page = pages.size();
+      size_t used = 0;
+      pages.emplace_back();
+      std::deque<const Radix_Node *> queue{root};
+      while (!queue.empty()) {
+        const Radix_Node *curr = queue.front();
+        queue.pop_front();
+
+        size_t size = _record_size(curr);
+        if (size > page_size)
+          throw std::invalid_argument(std::format(
+              "A node of {} bytes does not fit into a page of {} bytes.",
+              size, page_size));
+        if (used + size > page_size) {
+          roots.push_back(curr);
+          continue;
+        }
+
+        place(curr, page, used);
+        for (const Radix_Node *child : _sorted_children(curr))
+          queue.push_back(child);
+      }
+    }
+
+    uint64_t n_pages = 1 + n_pinned + pages.size();
+    if (n_pages > UINT32_MAX)
+      throw std::runtime_error("Paged radix trie has too many pages.");
+
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    if (!os)
+      throw std::runtime_error(
+          std::format("Failed to open \"{}\" for writing.", path.string()));
+
+    std::string buf(_magic);
+    _put_u32(buf, _version);
+    _put_u32(buf, static_cast<uint32_t>(page_size));
+    _put_u32(buf, 1);
+    _put_u32(buf, static_cast<uint32_t>(n_pinned));
+    _put_u32(buf, static_cast<uint32_t>(n_pages));
+    buf.resize(page_size, '\0');
+    os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+
+    buf.clear();
+    for (const Radix_Node *node : pinned)
+      _put_record(buf, node, refs);
+    buf.resize(n_pinned * page_size, '\0');
+    os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+
+    for (const auto &members : pages) {
+      buf.clear();
+      for (const Radix_Node *node : members)
+        _put_record(buf, node, refs);
+      buf.resize(page_size, '\0');
+      os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+    }
+
+    if (!os)
+      throw std::runtime_error("Failed to write paged radix trie.");
+  }
+
+  /**
+   * @brief Writes the trie of a sorted sequence of keys in the paged layout,
+   * without building the trie in memory.
+   *
+   * Keys are added to the rightmost path of the trie. A node is complete once
+   * a key no longer shares its path, and its record is written bottom-up,
+   * after the records of its children, so every reference is known when a
+   * record is written. A complete subtree that fits into a page is held back
+   * and stored whole; once it grows past a page, its held-back children are
+   * packed into data pages and only its top node is held further. Nodes above
+   * the pin depth stay in memory and are written as the pinned region after
+   * the data pages. Memory thus holds the current path, at most about a page
+   * of records per node on it, the pinned nodes and one page buffer.
+   *
+   * The file answers every query like the file write() produces for the
+   * same keys, but nodes are grouped into pages bottom-up, so a lookup may
+   * read a few more pages.
+   *
+   * Space complexity:  O(l*s + p); l is the length of the longest key, s is
+   *                    the page size, p is the size of the pinned nodes.
+   * Time complexity:   O(n); n is the total length of the keys.
+   *
+   * @param keys        A range of keys, convertible to std::string_view, in
+   *                    ascending order of their bytes as unsigned chars.
+   *                    Repeated keys are stored once.
+   * @param path        The file to write to. It is overwritten.
+   * @param page_size   Size of a page in bytes. Default is 4096.
+   * @param pin_depth   Number of trie levels, starting at the root, that
+   *                    are kept in memory. At least the root is. Default is 2.
+   * @throws            std::invalid_argument if the keys are not sorted or a
+   *                    node does not fit into a page, std::runtime_error if
+   *                    writing fails.
+   */
+  template <std::ranges::input_range R>
+    requires std::convertible_to<std::ranges::range_reference_t<R>,
+                                 std::string_view>
+  static void write_sorted(R &&keys, const std::filesystem::path &path,
+                           size_t page_size = 4096, size_t pin_depth = 2) {
+    _Sorted_Writer writer(path, page_size, pin_depth);
+    for (auto &&entry : keys)
+      writer.add(std::string_view(entry));
+    writer.finish();
+  }
+
+  /**
+   * @brief Writes the trie of the sorted lines of a stream in the paged
+   * layout. Empty lines are skipped and a trailing '\r' is stripped from each
+   * line, as in Radix_Trie::load_lines(). See write_sorted(R &&, const
+   * std::filesystem::path &, size_t, size_t).
+   *
+   * @param is          The stream of newline-delimited keys.
+   * @param path        The file to write to. It is overwritten.
+   * @param page_size   Size of a page in bytes. Default is 4096.
+   * @param pin_depth   Number of trie levels, starting at the root, that
+   *                    are kept in memory. At least the root is. Default is 2.
+   * @throws            std::invalid_argument if the keys are not sorted or a
+   *                    node does not fit into a page, std::runtime_error if
+   *                    writing fails.
+   */
+  static void write_sorted(std::istream &is, const std::filesystem::path &path,
+                           size_t page_size = 4096, size_t pin_depth = 2) {
+    _Sorted_Writer writer(path, page_size, pin_depth);
+    std::string line;
+    while (std::getline(is, line)) {
+      if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+      if (!line.empty())
+        writer.add(line);
+    }
+    writer.finish();
+  }
+
+  /**
+   * @brief Checks whether a word is stored.
+   *
+   * Space complexity:  O(1).
+   * Time complexity:   O(n log k); n is the length of the word, k is the
+   *                    largest fanout, plus one page read per page entered
+   *                    that is not cached.
+   *
+   * @param word        The word to search for.
+   * @return            True if the word is stored, else false.
+   */
+  bool contains(std::string_view word) const {
+    _Node curr = _node(_root_ref());
+    size_t w_idx = 0;
+
+    while (w_idx < word.size()) {
+      auto child = _child(curr, word[w_idx]);
+      if (!child)
+        return false;
+
+      curr = _node(*child);
+      if (curr.label.size() > word.size() - w_idx ||
+          word.substr(w_idx, curr.label.size()) != curr.label)
+        return false;
+      w_idx += curr.label.size();
+    }
+
+    return curr.is_word;
+  }
+
+  /**
+   * @brief Finds all completions for a given prefix that form a word, in
+   * lexicographic order. Like Radix_Trie::complete(), the completions are
+   * the remainders after the prefix, and the prefix itself is not included.
+   *
+   * Space complexity:  O(n); n is the size of the out_vec.
+   * Time complexity:   O(n*h); n is the size of the prefix, h is number of
+   *                    nodes in the relevant subtree, plus one page read per
+   *                    page entered that is not cached.
+   *
+   * @param pref        A string that needs to be completed.
+   * @param out_vec     A vector of strings that should be populated with
+   *                    completions.
+   */
+  void complete(std::string_view pref,
+                std::vector<std::string> &out_vec) const {
+    uint64_t curr_ref = _root_ref();
+    size_t pref_idx = 0;
+    std::string base;
+
+    while (pref_idx < pref.size()) {
+      auto child = _child(_node(curr_ref), pref[pref_idx]);
+      if (!child)
+        return;
+
+      curr_ref = *child;
+      std::string_view label = _node(curr_ref).label;
+      size_t match_len = std::min(label.size(), pref.size() - pref_idx);
+      if (label.substr(0, match_len) != pref.substr(pref_idx, match_len))
+        return;
+
+      pref_idx += match_len;
+      if (match_len < label.size())
+        base = label.substr(match_len);
+    }
+
+    // Each frame is a node and the base length before its label is added.
+    // Only references are kept, since fetching a page may evict another.
+    std::vector<std::pair<uint64_t, size_t>> stack;
+    _Node start = _node(curr_ref);
+    if (start.is_word && !base.empty())
+      out_vec.push_back(base);
+    for (size_t i = start.n_children; i-- > 0;)
+      stack.emplace_back(_child_at(start, i), base.size());
+
+    while (!stack.empty()) {
+      auto [ref, base_size] = stack.back();
+      stack.pop_back();
+
+      _Node curr = _node(ref);
+      base.resize(base_size);
+      base += curr.label;
+      if (curr.is_word)
+        out_vec.push_back(base);
+      for (size_t i = curr.n_children; i-- > 0;)
+        stack.emplace_back(_child_at(curr, i), base.size());
+    }
+  }
+
+  /**
+   * @brief Returns the number of pages read from disk since opening,
+   * excluding the pinned region.
+   */
+  size_t page_reads() const { return _page_reads; }
+
+private:
+  /**
+   * @brief A decoded view of a node record inside a page.
+   */
+  struct _Node {
+    std::string_view label;
+    const char *refs;
+    const char *keys;
+    uint32_t n_children;
+    bool is_word;
+  };
+
+  /**
+   * @brief A buffer pool frame.
+   */
+  struct _Frame {
+    uint32_t page;
+    bool referenced;
+    std::vector<char> data;
+  };
+
+  struct _Build_Node;
+
+  /**
+   * @brief A child slot of a node built by write_sorted(). The child is
+   * either written, with its reference, or still in memory, with the record
+   * size of the part of its subtree that is not written yet.
+   */
+  struct _Build_Child {
+    unsigned char key;
+    uint64_t ref;
+    std::unique_ptr<_Build_Node> node;
+    size_t size;
+  };
+
+  /**
+   * @brief A node built by write_sorted(), kept in memory until written.
+   */
+  struct _Build_Node {
+    std::string label;
+    bool is_word = false;
+    uint64_t ref = 0;
+    std::vector<_Build_Child> children;
+
+    /**
+     * @brief Total size of the children still in memory.
+     */
+    size_t pending = 0;
+  };
+
+  /**
+   * @brief Builds the paged file of a sorted key sequence bottom-up. See
+   * write_sorted().
+   */
+  class _Sorted_Writer {
+  public:
+    _Sorted_Writer(const std::filesystem::path &path, size_t page_size,
+                   size_t pin_depth)
+        : _page_size(page_size), _pin_depth(std::max<size_t>(pin_depth, 1)) {
+      if (page_size < _header_size || page_size > UINT32_MAX)
+        throw std::invalid_argument(
+            std::format("Invalid page size {}.", page_size));
+
+      _os.open(path, std::ios::binary | std::ios::trunc);
+      if (!_os)
+        throw std::runtime_error(
+            std::format("Failed to open \"{}\" for writing.", path.string()));
+
+      // Page 0 is the header, filled in by finish().
+      _page.assign(page_size, '\0');
+      _flush_page();
+      _spine.push_back({0, std::make_unique<_Build_Node>()});
+    }
+
+    /**
+     * @brief Adds the next key. Closes every node of the current path that
+     * the key leaves, splitting the one it leaves in the middle of its label.
+     */
+    void add(std::string_view key) {
+      size_t common = 0;
+      if (_started) {
+        if (key < _prev)
+          throw std::invalid_argument(
+              "Keys passed to write_sorted() are not sorted.");
+        if (key == _prev)
+          return;
+        common = static_cast<size_t>(
+            std::ranges::mismatch(key, _prev).in1 - key.begin());
+      }
+      _started = true;
+      _prev.assign(key);
+
+      while (_spine.size() > 1 && _spine.back().start >= common)
+        _close_top();
+
+      _Frame_Entry &top = _spine.back();
+      if (top.start + top.node->label.size() > common) {
+        size_t cut = common - top.start;
+        auto prefix = std::make_unique<_Build_Node>();
+        prefix->label = top.node->label.substr(0, cut);
+        top.node->label.erase(0, cut);
+        std::unique_ptr<_Build_Node> rest = std::move(top.node);
+        top.node = std::move(prefix);
+        _deepen(*rest, _spine.size());
+        _attach(*top.node, std::move(rest), _spine.size());
+      }
+
+      if (key.size() == common) {
+        _spine.back().node->is_word = true;
+        return;
+      }
+      auto node = std::make_unique<_Build_Node>();
+      node->label = key.substr(common);
+      node->is_word = true;
+      _spine.push_back({common, std::move(node)});
+    }
+
+    /**
+     * @brief Closes the remaining path, writes the pinned region and the
+     * header.
+     */
+    void finish() {
+      while (_spine.size() > 1)
+        _close_top();
+      _Build_Node &root = *_spine.back().node;
+      if (_pin_depth == 1)
+        _place_children(root);
+      if (!_page.empty())
+        _flush_page();
+
+      // Pinned region: the nodes still in memory, in preorder from the root.
+      uint64_t pinned_first = _n_pages;
+      std::vector<_Build_Node *> pinned;
+      std::vector<_Build_Node *> stack{&root};
+      uint64_t pinned_size = 0;
+      while (!stack.empty()) {
+        _Build_Node *curr = stack.back();
+        stack.pop_back();
+        curr->ref = ((pinned_first + pinned_size / _page_size) << 32) |
+                    (pinned_size % _page_size);
+        pinned.push_back(curr);
+        pinned_size += _record_size(*curr);
+        for (size_t i = curr->children.size(); i-- > 0;)
+          if (curr->children[i].node)
+            stack.push_back(curr->children[i].node.get());
+      }
+
+      std::string buf;
+      for (const _Build_Node *node : pinned)
+        _put_record(buf, *node);
+      uint64_t n_pinned =
+          std::max<uint64_t>(1, (buf.size() + _page_size - 1) / _page_size);
+      buf.resize(n_pinned * _page_size, '\0');
+      uint64_t n_pages = pinned_first + n_pinned;
+      if (n_pages > UINT32_MAX)
+        throw std::runtime_error("Paged radix trie has too many pages.");
+      _os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+
+      std::string header(_magic);
+      _put_u32(header, _version);
+      _put_u32(header, static_cast<uint32_t>(_page_size));
+      _put_u32(header, static_cast<uint32_t>(pinned_first));
+      _put_u32(header, static_cast<uint32_t>(n_pinned));
+      _put_u32(header, static_cast<uint32_t>(n_pages));
+      _os.seekp(0);
+      _os.write(header.data(), static_cast<std::streamsize>(header.size()));
+      _os.flush();
+      if (!_os)
+        throw std::runtime_error("Failed to write paged radix trie.");
+    }
+
+  private:
+    /**
+     * @brief A node on the current path and the length of the path above
+     * its label.
+     */
+    struct _Frame_Entry {
+      size_t start;
+      std::unique_ptr<_Build_Node> node;
+    };
+
+    std::ofstream _os;
+    size_t _page_size;
+    size_t _pin_depth;
+    std::vector<_Frame_Entry> _spine;
+    std::string _prev;
+    bool _started = false;
+
+    /**
+     * @brief The data page being filled and the number of pages written.
+     */
+    std::string _page;
+    uint64_t _n_pages = 0;
+
+    void _close_top() {
+      std::unique_ptr<_Build_Node> node = std::move(_spine.back().node);
+      _spine.pop_back();
+      _attach(*_spine.back().node, std::move(node), _spine.size());
+    }
+
+    /**
+     * @brief Adds a complete node as the last child of its parent.
+     *
+     * @param depth       Depth of the child; the root is at depth 0.
+     */
+    void _attach(_Build_Node &parent, std::unique_ptr<_Build_Node> child,
+                 size_t depth) {
+      auto key = static_cast<unsigned char>(child->label[0]);
+      if (depth < _pin_depth) {
+        if (depth + 1 == _pin_depth)
+          _place_children(*child);
+        parent.children.push_back({key, 0, std::move(child), 0});
+        return;
+      }
+
+      size_t record = _checked_record_size(*child);
+      if (record + child->pending > _page_size)
+        _place_children(*child);
+
+      size_t size = record + child->pending;
+      parent.children.push_back({key, 0, std::move(child), size});
+      parent.pending += size;
+      if (parent.pending > _page_size)
+        _place_children(parent);
+    }
+
+    /**
+     * @brief Updates a closed subtree that a split moved one level down, to
+     * the given depth. Its nodes at the level above the pin depth held their
+     * children as pinned, with no size; those children are now below the pin
+     * depth, so they get their sizes and are written like any other.
+     *
+     * @param depth       New depth of the subtree root.
+     */
+    void _deepen(_Build_Node &node, size_t depth) {
+      if (depth >= _pin_depth)
+        return;
+      std::vector<std::pair<_Build_Node *, size_t>> stack{{&node, depth}};
+      while (!stack.empty()) {
+        auto [curr, curr_depth] = stack.back();
+        stack.pop_back();
+        if (curr_depth + 1 < _pin_depth) {
+          for (_Build_Child &child : curr->children)
+            if (child.node)
+              stack.emplace_back(child.node.get(), curr_depth + 1);
+          continue;
+        }
+
+        // The children of curr are at the pin depth now. Their own children
+        // were written when they were closed, so only their records remain.
+        for (_Build_Child &child : curr->children)
+          if (child.node) {
+            child.size =
+                _checked_record_size(*child.node) + child.node->pending;
+            curr->pending += child.size;
+          }
+        _place_children(*curr);
+      }
+    }
+
+    /**
+     * @brief Writes every child subtree of a node that is still in memory.
+     * Only called on nodes whose children are below the pin depth.
+     */
+    void _place_children(_Build_Node &node) {
+      for (_Build_Child &child : node.children)
+        if (child.node)
+          _place(child);
+      node.pending = 0;
+    }
+
+    /**
+     * @brief Writes a subtree that fits into a page into the current data
+     * page, or a fresh one if it does not fit, in preorder. The fit is
+     * checked against the records of the subtree, not the slot size.
+     *
+     * @throws            std::logic_error if the subtree does not fit into a
+     *                    page.
+     */
+    void _place(_Build_Child &slot) {
+      std::vector<_Build_Node *> order;
+      std::vector<_Build_Node *> stack{slot.node.get()};
+      size_t size = 0;
+      while (!stack.empty()) {
+        _Build_Node *curr = stack.back();
+        stack.pop_back();
+        size += _record_size(*curr);
+        order.push_back(curr);
+        for (size_t i = curr->children.size(); i-- > 0;)
+          if (curr->children[i].node)
+            stack.push_back(curr->children[i].node.get());
+      }
+      if (size > _page_size)
+        throw std::logic_error(std::format(
+            "A subtree of {} bytes was placed into a page of {} bytes.", size,
+            _page_size));
+      if (_page.size() + size > _page_size)
+        _flush_page();
+
+      size_t used = _page.size();
+      for (_Build_Node *node : order) {
+        node->ref = (_n_pages << 32) | used;
+        used += _record_size(*node);
+      }
+      for (const _Build_Node *node : order)
+        _put_record(_page, *node);
+      slot.ref = slot.node->ref;
+      slot.node.reset();
+    }
+
+    void _flush_page() {
+      if (_n_pages >= UINT32_MAX)
+        throw std::runtime_error("Paged radix trie has too many pages.");
+      _page.resize(_page_size, '\0');
+      _os.write(_page.data(), static_cast<std::streamsize>(_page.size()));
+      if (!_os)
+        throw std::runtime_error("Failed to write paged radix trie.");
+      _page.clear();
+      _n_pages++;
+    }
+
+    static size_t _record_size(const _Build_Node &node) {
+      return 8 + 9 * node.children.size() + node.label.size();
+    }
+
+    /**
+     * @throws            std::invalid_argument if the record of the node
+     *                    does not fit into a page.
+     */
+    size_t _checked_record_size(const _Build_Node &node) const {
+      size_t record = _record_size(node);
+      if (record > _page_size)
+        throw std::invalid_argument(std::format(
+            "A node of {} bytes does not fit into a page of {} bytes.", record,
+            _page_size));
+      return record;
+    }
+
+    static void _put_record(std::string &out, const _Build_Node &node) {
+      _put_u32(out, static_cast<uint32_t>(node.label.size()));
+      _put_u32(out, static_cast<uint32_t>(node.children.size() << 1) |
+                        node.is_word);
+      for (const _Build_Child &child : node.children)
+        _put_u64(out, child.node ? child.node->ref : child.ref);
+      for (const _Build_Child &child : node.children)
+        out.push_back(static_cast<char>(child.key));
+      out += node.label;
+    }
+  };
+
+  static constexpr std::string_view _magic = "RDXP";
+  static constexpr uint32_t _version = 1;
+  static constexpr size_t _header_size = 24;
+
+  std::filesystem::path _path;
+  int _fd = -1;
+  uint32_t _page_size = 0;
+  uint32_t _n_pages = 0;
+
+  /**
+   * @brief The pinned region, covering pages _pinned_first to _pinned_end.
+   */
+  std::vector<char> _pinned;
+  uint32_t _pinned_first = 0;
+  uint32_t _pinned_end = 0;
+
+  /**
+   * @brief The buffer pool: frames, their index by page and the CLOCK hand.
+   */
+  size_t _n_frames;
+  mutable std::vector<_Frame> _frames;
+  mutable std::unordered_map<uint32_t, size_t> _page_table;
+  mutable size_t _hand = 0;
+  mutable size_t _page_reads = 0;
+
+  [[noreturn]] void _throw_errno(const char *what) const {
+    throw std::system_error(errno, std::generic_category(),
+                            std::format("{} \"{}\"", what, _path.string()));
+  }
+
+  static void _put_u32(std::string &out, uint32_t val) {
+    for (int i = 0; i < 4; i++)
+      out.push_back(static_cast<char>(val >> (8 * i)));
+  }
+
+  static void _put_u64(std::string &out, uint64_t val) {
+    for (int i = 0; i < 8; i++)
+      out.push_back(static_cast<char>(val >> (8 * i)));
+  }
+
+  template <typename T> static T _load(const char *pos) {
+    T val;
+    std::memcpy(&val, pos, sizeof(val));
+    if constexpr (std::endian::native == std::endian::big)
+      val = std::byteswap(val);
+    return val;
+  }
+
+  static uint32_t _get_u32(const char *pos) { return _load<uint32_t>(pos); }
+
+  static size_t _record_size(const Radix_Node *node) {
+    return 8 + 9 * node->children.size() + node->val.size();
+  }
+
+  /**
+   * @brief Computes the record size of every subtree below a root, capped
+   * just above the page size since larger subtrees are split anyway.
+   */
+  static void
+  _subtree_sizes(const Radix_Node *root, size_t page_size,
+                 std::unordered_map<const Radix_Node *, size_t> &sizes) {
+    // Postorder: a node is summed once all its children are.
+    std::vector<std::pair<const Radix_Node *, bool>> stack{{root, false}};
+    while (!stack.empty()) {
+      auto [curr, expanded] = stack.back();
+      stack.pop_back();
+      if (!expanded) {
+        stack.emplace_back(curr, true);
+        for (const auto &entry : curr->children)
+          stack.emplace_back(entry.second, false);
+        continue;
+      }
+
+      size_t size = _record_size(curr);
+      for (const auto &entry : curr->children)
+        size = std::min(size + sizes[entry.second], page_size + 1);
+      sizes[curr] = size;
+    }
+  }
+
+  static std::vector<const Radix_Node *>
+  _sorted_children(const Radix_Node *node) {
+    std::vector<const Radix_Node *> children;
+    for (const auto &entry : node->children)
+      children.push_back(entry.second);
+    std::ranges::sort(children, {}, [](const Radix_Node *child) {
+      return static_cast<unsigned char>(child->val[0]);
+    });
+    return children;
+  }
+
+  static void
+  _put_record(std::string &out, const Radix_Node *node,
+              const std::unordered_map<const Radix_Node *, uint64_t> &refs) {
+    std::vector<const Radix_Node *> children = _sorted_children(node);
+
+    _put_u32(out, static_cast<uint32_t>(node->val.size()));
+    _put_u32(out, static_cast<uint32_t>(children.size() << 1) | node->is_word);
+    for (const Radix_Node *child : children)
+      _put_u64(out, refs.at(child));
+    for (const Radix_Node *child : children)
+      out.push_back(child->val[0]);
+    out += node->val;
+  }
+
+  void _read_at(char *buf, size_t size, size_t offset) const {
+    while (size) {
+      ssize_t n = ::pread(_fd, buf, size, static_cast<off_t>(offset));
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n < 0)
+        _throw_errno("pread");
+      if (n == 0)
+        throw std::runtime_error(std::format(
+            "Unexpected end of paged radix trie \"{}\".", _path.string()));
+      buf += n;
+      size -= static_cast<size_t>(n);
+      offset += static_cast<size_t>(n);
+    }
+  }
+
+  uint64_t _root_ref() const { return uint64_t{_pinned_first} << 32; }
+
+  /**
+   * @brief Returns the bytes of a page, reading it into the buffer pool if
+   * it is not cached.
+   *
+   * @param page        The page number.
+   * @return            Pointer to the page bytes, valid until the next call.
+   */
+  const char *_page(uint32_t page) const {
+    if (page >= _pinned_first && page < _pinned_end)
+      return _pinned.data() + size_t{page - _pinned_first} * _page_size;
+    if (page >= _n_pages)
+      throw std::runtime_error("Corrupt paged radix trie: bad page number.");
+
+    auto it = _page_table.find(page);
+    if (it != _page_table.end()) {
+      _frames[it->second].referenced = true;
+      return _frames[it->second].data.data();
+    }
+
+    size_t slot;
+    if (_frames.size() < _n_frames) {
+      slot = _frames.size();
+      _frames.push_back({page, true, std::vector<char>(_page_size)});
+    } else {
+      // CLOCK: skip and clear referenced frames until an unreferenced one.
+      while (_frames[_hand].referenced) {
+        _frames[_hand].referenced = false;
+        _hand = (_hand + 1) % _frames.size();
+      }
+      slot = _hand;
+      _hand = (_hand + 1) % _frames.size();
+      _page_table.erase(_frames[slot].page);
+      _frames[slot].page = page;
+      _frames[slot].referenced = true;
+    }
+
+    _page_table[page] = slot;
+    try {
+      _read_at(_frames[slot].data.data(), _page_size,
+               size_t{page} * _page_size);
+    } catch (...) {
+      _page_table.erase(page);
+      _frames[slot].page = UINT32_MAX;
+      throw;
+    }
+    _page_reads++;
+    return _frames[slot].data.data();
+  }
+
+  /**
+   * @brief Decodes the node record a reference points to.
+   *
+   * @param ref         The node reference.
+   * @return            A view of the record, valid until the next page
+   *                    fetch.
+   * @throws            std::runtime_error if the record lies outside its
+   *                    page.
+   */
+  _Node _node(uint64_t ref) const {
+    auto page = static_cast<uint32_t>(ref >> 32);
+    auto offset = static_cast<uint32_t>(ref);
+    bool pinned = page >= _pinned_first && page < _pinned_end;
+    size_t limit = pinned ? _pinned.size() -
+                                size_t{page - _pinned_first} * _page_size
+                          : _page_size;
+
+    const char *rec = _page(page) + offset;
+    if (size_t{offset} + 8 > limit)
+      throw std::runtime_error("Corrupt paged radix trie: bad node offset.");
+
+    uint32_t label_size = _get_u32(rec);
+    uint32_t meta = _get_u32(rec + 4);
+    uint32_t n_children = meta >> 1;
+    size_t label_pos = 8 + 9 * size_t{n_children};
+    if (n_children > 256 || offset + label_pos + label_size > limit)
+      throw std::runtime_error("Corrupt paged radix trie: bad node record.");
+
+    return {{rec + label_pos, label_size},
+            rec + 8,
+            rec + 8 + 8 * size_t{n_children},
+            n_children,
+            static_cast<bool>(meta & 1)};
+  }
+
+  static uint64_t _child_at(const _Node &node, size_t i) {
+    return _load<uint64_t>(node.refs + 8 * i);
+  }
+
+  /**
+   * @brief Finds the child whose label starts with a given byte.
+   *
+   * @param node        The parent node.
+   * @param c           First byte of the child label.
+   * @return            Reference of the child, or std::nullopt if there is
+   *                    none.
+   */
+  static std::optional<uint64_t> _child(const _Node &node, char c) {
+    auto keys = reinterpret_cast<const unsigned char *>(node.keys);
+    const unsigned char *end = keys + node.n_children;
+    auto key = static_cast<unsigned char>(c);
+    const unsigned char *it = std::lower_bound(keys, end, key);
+    if (it == end || *it != key)
+      return {};
+    return _child_at(node, static_cast<size_t>(it - keys));
+  }
+};
+
+} // namespace radix_trie
@@ -12,10 +12,39 @@
 
 #pragma once
 
+#include "bloom_filter.hpp"
+#include "instrument.hpp"
+#include "mismatch.hpp"
+#include "varint.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
 #include <format>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <numeric>
 #include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace radix_trie {
@@ -37,19 +66,27 @@ struct Radix_Node {
   /**
    * @brief Indicates whether this node represents the end of a valid word.
    */
-  bool is_word;
+  bool is_word = false;
+
+  /**
+   * @brief Indicates whether this node or anything below it changed since
+   * the last checkpoint. Nodes start out dirty.
+   */
+  bool is_dirty = true;
 
   /**
    * @brief Default constructor.
    */
-  Radix_Node() = default;
+  Radix_Node() { RADIX_TRIE_COUNT(allocs, 1); }
 
   /**
    * @brief Constructs a terminal node with a given value.
    *
    * @param val   The string segment this node represents.
    */
-  Radix_Node(std::string val) : val(val), is_word(true) {}
+  Radix_Node(std::string val) : val(val), is_word(true) {
+    RADIX_TRIE_COUNT(allocs, 1);
+  }
 
   /**
    * @brief Constructs a node with a given word flag and value.
@@ -57,17 +94,153 @@ struct Radix_Node {
    * @param val       The string segment this node represents.
    * @param is_word   Whether this node marks the end of a word.
    */
-  Radix_Node(std::string val, bool is_word) : val(val), is_word(is_word) {}
+  Radix_Node(std::string val, bool is_word) : val(val), is_word(is_word) {
+    RADIX_TRIE_COUNT(allocs, 1);
+  }
 
   /**
    * @brief Destructor. Frees all dynamically allocated child nodes.
+   *
+   * Descendants are freed in postorder with an explicit stack of child
+   * iterators, one per level, so deep tries do not overflow the call stack.
+   * Null children are skipped.
    */
   ~Radix_Node() {
-    for (auto &entry : children)
-      delete entry.second;
+    RADIX_TRIE_COUNT(frees, 1);
+    if (children.empty())
+      return;
+
+    using Iter = std::unordered_map<char, Radix_Node *>::iterator;
+    std::vector<std::pair<Radix_Node *, Iter>> stack{{this, children.begin()}};
+    while (!stack.empty()) {
+      auto &[node, it] = stack.back();
+      if (it == node->children.end()) {
+        // Emptied first, so its own destructor has nothing left to free.
+        node->children.clear();
+        Radix_Node *done = node;
+        stack.pop_back();
+        if (done != this)
+          delete done;
+        continue;
+      }
+
+      Radix_Node *child = (it++)->second;
+      if (!child)
+        continue;
+      if (child->children.empty())
+        delete child;
+      else
+        stack.emplace_back(child, child->children.begin());
+    }
+  }
+};
+
+/**
+ * @brief Memory footprint of a Radix Trie, as reported by
+ * Radix_Trie::memory_usage().
+ */
+struct Memory_Usage {
+  /**
+   * @brief Bytes of the node objects themselves.
+   */
+  size_t nodes = 0;
+
+  /**
+   * @brief Heap bytes of the child maps: bucket arrays and entries.
+   */
+  size_t child_containers = 0;
+
+  /**
+   * @brief Heap bytes of edge labels too long for the small-string buffer.
+   */
+  size_t labels = 0;
+
+  /**
+   * @brief Bytes of the Bloom filter, if enabled.
+   */
+  size_t filter = 0;
+
+  /**
+   * @brief Estimated malloc headers and rounding of all the allocations
+   * above.
+   */
+  size_t allocator_overhead = 0;
+
+  /**
+   * @brief Number of nodes, including the root.
+   */
+  size_t node_count = 0;
+
+  /**
+   * @brief Detailed mode only. Number of nodes by their number of children.
+   */
+  std::vector<size_t> fanout;
+
+  /**
+   * @brief Detailed mode only. Number of labels by length class: index 0
+   * counts empty labels, index i counts lengths in [2^(i-1), 2^i).
+   */
+  std::vector<size_t> label_lengths;
+
+  /**
+   * @brief Returns the total number of bytes.
+   */
+  size_t total() const {
+    return nodes + child_containers + labels + filter + allocator_overhead;
   }
 };
 
+/**
+ * @brief Shape of a Radix Trie, as reported by Radix_Trie::stats().
+ */
+struct Trie_Stats {
+  /**
+   * @brief Number of nodes, including the root.
+   */
+  size_t node_count = 0;
+
+  /**
+   * @brief Number of nodes that end a word.
+   */
+  size_t word_count = 0;
+
+  /**
+   * @brief Largest number of edges from the root to a node.
+   */
+  size_t max_depth = 0;
+
+  /**
+   * @brief Mean number of edges from the root to a word, which is the number
+   * of nodes a successful find() visits.
+   */
+  double average_depth = 0;
+
+  /**
+   * @brief Share of nodes with exactly one child. Such nodes end a word that
+   * is a prefix of longer words, and long runs of them make lookups visit
+   * many short labels.
+   */
+  double single_child_share = 0;
+
+  /**
+   * @brief Longest run of consecutive single-child nodes on one path.
+   */
+  size_t longest_chain = 0;
+
+  /**
+   * @brief Number of nodes by their number of children.
+   */
+  std::vector<size_t> fanout;
+
+  /**
+   * @brief Number of labels by length class: index 0 counts empty labels,
+   * index i counts lengths in [2^(i-1), 2^i).
+   */
+  std::vector<size_t> label_lengths;
+};
+
+class Completion_Session;
+
 /**
  * @brief A Radix Trie (Compact Prefix Tree) implementation
  */
@@ -76,12 +249,14 @@ public:
   /**
    * @brief Constructs an empty Radix Trie.
    */
-  explicit Radix_Trie() : _root(new Radix_Node) {}
+  explicit Radix_Trie() : _root(new Radix_Node) {
+    _footprint += _Footprint::of(_root);
+  }
 
   /**
    * @brief Destroys the trie and deallocates all nodes.
    */
-  ~Radix_Trie() { delete _root; }
+  ~Radix_Trie() { _delete_nodes(); }
 
   /**
    * @brief Inserts a word into the trie.
@@ -90,50 +265,116 @@ public:
    * Time complexity:   O(n), n is the length of the word.
    *
    * @param word        The word to insert.
+   * @throws            std::logic_error if the trie is frozen.
    */
-  void insert(const std::string &word) {
-    Radix_Node *curr = _root;
-    Radix_Node *prev = _root;
+  void insert(std::string_view word) {
+    RADIX_TRIE_TIME(insert);
+    _check_mutable();
+    if (_insert(_root, word, _footprint))
+      _filter_add(word);
+  }
 
-    size_t w_size = word.size();
-    size_t w_idx = 0;
-    while (w_idx < w_size) {
+  /**
+   * @brief Inserts many words using several worker threads.
+   *
+   * Words are partitioned by their first character. A partition holding
+   * more than its share of the words, as when most keys start with
+   * "https://" or "/usr/", is split again below the longest prefix its words
+   * share, until every partition is small enough. The node that ends at that
+   * prefix is created first, so each partition is the subtree below one
+   * child slot. Workers build the partitions in their own subtrees, which
+   * are then spliced into place. Existing subtrees are moved to the worker
+   * that owns their slot, so the resulting trie is identical to inserting
+   * the words one by one.
+   *
+   * Space complexity:  O(w); w is the number of words.
+   * Time complexity:   O(n/t); n is the total length of the words, t is the
+   *                    number of threads.
+   *
+   * @param words       A range of words, convertible to std::string_view.
+   * @param n_threads   Number of worker threads. Default is the number of
+   *                    hardware threads.
+   * @throws            std::logic_error if the trie is frozen.
+   */
+  template <std::ranges::input_range R>
+    requires std::convertible_to<std::ranges::range_reference_t<R>,
+                                 std::string_view>
+  void insert_parallel(const R &words,
+                       size_t n_threads = std::thread::hardware_concurrency()) {
+    _check_mutable();
+    std::vector<_Partition> parts(1);
+    for (const auto &entry : words) {
+      std::string_view word = entry;
+      if (word.empty())
+        _root->is_word = _root->is_dirty = true;
+      else
+        parts[0][static_cast<unsigned char>(word[0])].push_back(word);
+    }
 
-      char c = word[w_idx];
-      if (!curr->children.contains(c)) {
-        curr->children[c] = new Radix_Node{word.substr(w_idx, w_size)};
-        return;
-      }
+    _insert_partitioned(std::move(parts), n_threads);
+  }
 
-      prev = curr;
-      curr = curr->children[c];
+  /**
+   * @brief Inserts every line of a newline-delimited file as a word.
+   *
+   * The file is read in large blocks and line boundaries are found with
+   * memchr, which the C library vectorizes. Words are inserted straight from
+   * the read buffer without copying lines out. Empty lines are skipped and a
+   * trailing '\r' is stripped from each line. Words already in the trie are
+   * kept.
+   *
+   * With more than one thread the whole file is read at once, every worker
+   * splits its own slice of the buffer into lines, and the words are inserted
+   * as in insert_parallel().
+   *
+   * Space complexity:  O(b) with one thread, b is the block size. O(f)
+   *                    otherwise, f is the size of the file.
+   * Time complexity:   O(f/t); f is the size of the file, t is the number of
+   *                    threads.
+   *
+   * @param path        The file to read.
+   * @param n_threads   Number of worker threads. Default is 1.
+   * @throws            std::runtime_error if the file cannot be read.
+   * @throws            std::logic_error if the trie is frozen.
+   */
+  void load_lines(const std::filesystem::path &path, size_t n_threads = 1) {
+    _check_mutable();
+    std::ifstream is(path, std::ios::binary);
+    if (!is)
+      throw std::runtime_error(
+          std::format("Failed to open \"{}\" for reading.", path.string()));
 
-      size_t curr_size = curr->val.size();
-      size_t curr_idx = 0;
-      while (curr_idx < curr_size && w_idx < w_size) {
-
-        if (word[w_idx] != curr->val[curr_idx]) {
-          Radix_Node *common =
-              new Radix_Node{curr->val.substr(0, curr_idx), false};
-          common->children[word[w_idx]] =
-              new Radix_Node{word.substr(w_idx, w_size)};
-          _rebind(common, prev, curr, curr_idx);
-          return;
-        }
+    if (n_threads > 1) {
+      _load_lines_parallel(is, std::filesystem::file_size(path), n_threads);
+      return;
+    }
 
-        w_idx++;
-        curr_idx++;
-      }
+    std::vector<char> block(_line_block_size);
+    size_t carry = 0;
+    while (true) {
+      is.read(block.data() + carry,
+              static_cast<std::streamsize>(block.size() - carry));
+      size_t filled = carry + static_cast<size_t>(is.gcount());
+      if (is.bad())
+        throw std::runtime_error(
+            std::format("Failed to read \"{}\".", path.string()));
 
-      if (curr_idx < curr_size && w_idx == w_size) {
-        Radix_Node *common = new Radix_Node{curr->val.substr(0, curr_idx)};
-        _rebind(common, prev, curr, curr_idx);
+      bool eof = filled < block.size();
+      size_t consumed = _for_each_line(
+          {block.data(), filled}, eof,
+          [this](std::string_view line) {
+            if (_insert(_root, line, _footprint))
+              _filter_add(line);
+          });
+
+      if (eof)
         return;
-      }
-    }
 
-    if (w_idx == w_size)
-      curr->is_word = true;
+      carry = filled - consumed;
+      if (carry == block.size())
+        block.resize(2 * block.size());
+      std::memmove(block.data(), block.data() + consumed, carry);
+    }
   }
 
   /**
@@ -155,22 +396,23 @@ public:
    */
   std::optional<const Radix_Node *>
   find(const std::string &val, const bool allow_partial = false) const {
+    RADIX_TRIE_TIME(find);
     Radix_Node *curr = _root;
     size_t val_idx = 0;
 
     while (val_idx < val.size()) {
-      char c = val[val_idx];
-      if (!curr->children.contains(c))
+      auto it = curr->children.find(val[val_idx]);
+      if (it == curr->children.end())
         return {};
 
-      curr = curr->children[c];
+      curr = it->second;
       const std::string &curr_val = curr->val;
+      RADIX_TRIE_COUNT(nodes_visited, 1);
 
-      size_t match_len = 0;
-      while (match_len < curr_val.size() && val_idx + match_len < val.size() &&
-             curr_val[match_len] == val[val_idx + match_len]) {
-        match_len++;
-      }
+      size_t match_len =
+          mismatch(curr_val.data(), val.data() + val_idx,
+                   std::min(curr_val.size(), val.size() - val_idx));
+      RADIX_TRIE_COUNT(bytes_compared, match_len);
 
       if (match_len < curr_val.size()) {
         if (val_idx + match_len == val.size() && allow_partial) {
@@ -185,12 +427,187 @@ public:
     return curr;
   }
 
+  /**
+   * @brief Returns the root node, for read-only traversal of the whole trie.
+   * The root holds an empty value.
+   *
+   * @return            Pointer to the root node.
+   */
+  const Radix_Node *root() const { return _root; }
+
+  /**
+   * @brief Checks whether a word is stored. Unlike find(), only whole words
+   * match.
+   *
+   * With the Bloom filter enabled, most absent words are rejected by one
+   * cache line read before any node is visited.
+   *
+   * Space complexity:  O(1).
+   * Time complexity:   O(n); n is the length of the word.
+   *
+   * @param word        The word to search for.
+   * @return            True if the word is stored, else false.
+   */
+  bool contains(std::string_view word) const {
+    RADIX_TRIE_TIME(find);
+    if (_filter && !_filter->may_contain(word))
+      return false;
+    const Radix_Node *node = _locate(word).second;
+    return node && node->is_word;
+  }
+
+  /**
+   * @brief Maintains a blocked Bloom filter of the words next to the trie,
+   * which contains() consults first.
+   *
+   * insert() adds words to the filter. Since words cannot be taken out of a
+   * Bloom filter, the filter is rebuilt from the trie once removals reach a
+   * quarter of the words it holds, and when it fills up. Bulk operations
+   * (insert_parallel(), parallel load_lines(), load(), apply_delta())
+   * rebuild it once at the end. Calling this again rebuilds the filter.
+   *
+   * Space complexity:  O(n*b); n is the number of words, b is the number of
+   *                    bits per word.
+   * Time complexity:   O(n); n is the number of nodes.
+   *
+   * @param bits_per_key    Bits of filter per word. Default is 10, for a
+   *                        false positive rate of about 1%.
+   * @throws                std::invalid_argument if bits_per_key is not
+   *                        positive.
+   */
+  void enable_filter(double bits_per_key = 10) {
+    _filter = std::make_unique<Blocked_Bloom_Filter>(0, bits_per_key);
+    _filter_bits_per_key = bits_per_key;
+    _rebuild_filter();
+  }
+
+  /**
+   * @brief Drops the Bloom filter.
+   */
+  void disable_filter() { _filter.reset(); }
+
+  /**
+   * @brief Reports how much memory the trie uses.
+   *
+   * Node objects and label buffers are measured exactly. The child maps are
+   * measured from their bucket count and size with the node layout of the
+   * common standard libraries, and allocator overhead is estimated as in
+   * glibc malloc: an 8-byte header per allocation, 16-byte granularity and a
+   * 32-byte minimum. These byte counts are running totals that every
+   * operation changing a node keeps up to date, so the plain report is
+   * constant time and fit for frequent metrics collection. The detailed mode
+   * walks every node to add the fanout and label length histograms; in a
+   * frozen trie, shared nodes are counted once, which takes a set of the
+   * nodes seen.
+   *
+   * Space complexity:  O(1). O(h) in detailed mode, h is the height of the
+   *                    trie, or O(n) if the trie is frozen.
+   * Time complexity:   O(1). O(n) in detailed mode, n is the number of
+   *                    nodes.
+   *
+   * @param detailed    Whether to fill in the histograms. Default is false.
+   * @return            The memory footprint.
+   */
+  Memory_Usage memory_usage(bool detailed = false) const {
+    Memory_Usage usage;
+    usage.nodes = _footprint.nodes;
+    usage.child_containers = _footprint.child_containers;
+    usage.labels = _footprint.labels;
+    usage.allocator_overhead = _footprint.allocator_overhead;
+    usage.node_count = _footprint.node_count;
+    if (_filter) {
+      usage.filter = _filter->size_bytes();
+      usage.allocator_overhead += _Footprint::overhead(usage.filter);
+    }
+    if (!detailed)
+      return usage;
+
+    std::unordered_set<const Radix_Node *> seen;
+    std::vector<const Radix_Node *> stack{_root};
+    while (!stack.empty()) {
+      const Radix_Node *curr = stack.back();
+      stack.pop_back();
+      for (const auto &entry : curr->children)
+        if (!_frozen || seen.insert(entry.second).second)
+          stack.push_back(entry.second);
+
+      size_t fanout = curr->children.size();
+      if (usage.fanout.size() <= fanout)
+        usage.fanout.resize(fanout + 1);
+      usage.fanout[fanout]++;
+
+      size_t length_class = std::bit_width(curr->val.size());
+      if (usage.label_lengths.size() <= length_class)
+        usage.label_lengths.resize(length_class + 1);
+      usage.label_lengths[length_class]++;
+    }
+
+    return usage;
+  }
+
+  /**
+   * @brief Reports the shape of the trie: node and word counts, depths,
+   * fanout and label length distributions and single-child chains.
+   *
+   * Nodes shared by a frozen trie are counted once per path, so the
+   * figures describe the trie the words spell out.
+   *
+   * Space complexity:  O(h); h is the height of the trie.
+   * Time complexity:   O(n); n is the number of nodes.
+   *
+   * @return            The statistics.
+   */
+  Trie_Stats stats() const {
+    Trie_Stats stats;
+    size_t depth_sum = 0;
+    size_t single_child = 0;
+
+    // Each frame is a node, its depth and the length of the single-child
+    // run that ends at its parent.
+    std::vector<std::tuple<const Radix_Node *, size_t, size_t>> stack{
+        {_root, 0, 0}};
+    while (!stack.empty()) {
+      auto [curr, depth, chain] = stack.back();
+      stack.pop_back();
+
+      stats.node_count++;
+      stats.max_depth = std::max(stats.max_depth, depth);
+      if (curr->is_word) {
+        stats.word_count++;
+        depth_sum += depth;
+      }
+
+      size_t fanout = curr->children.size();
+      if (stats.fanout.size() <= fanout)
+        stats.fanout.resize(fanout + 1);
+      stats.fanout[fanout]++;
+
+      size_t length_class = std::bit_width(curr->val.size());
+      if (stats.label_lengths.size() <= length_class)
+        stats.label_lengths.resize(length_class + 1);
+      stats.label_lengths[length_class]++;
+
+      chain = fanout == 1 ? chain + 1 : 0;
+      single_child += fanout == 1;
+      stats.longest_chain = std::max(stats.longest_chain, chain);
+      for (const auto &entry : curr->children)
+        stack.emplace_back(entry.second, depth + 1, chain);
+    }
+
+    if (stats.word_count)
+      stats.average_depth = static_cast<double>(depth_sum) /
+                            static_cast<double>(stats.word_count);
+    stats.single_child_share = static_cast<double>(single_child) /
+                               static_cast<double>(stats.node_count);
+    return stats;
+  }
+
   /**
    * @brief Visualizes content of the trie, either by printing out each word or
    * the structure of the trie in markdown format.
    * When using markdown, '𐄂' annotates nodes that form a word.
    *
-   * Space complexity:  O(n); n is the height of the trie.
+   * Space complexity:  O(h); h is the height of the trie.
    * Time complexity:   O(n); n is the number of nodes.
    *
    * @param format      Give "list" for a list of words, "md" for
@@ -198,9 +615,9 @@ public:
    */
   void print(const std::string &format = "md") const {
     if (format == "md")
-      _print_md(_root, "#");
+      _print_md();
     else if (format == "list")
-      _print_list(_root, "");
+      _print_list();
     else
       throw std::invalid_argument(
           std::format("Invalid print argument format=\"{}\". Valid arguments "
@@ -209,20 +626,28 @@ public:
   }
 
   /**
-   * @brief Recursively removes a node or node path that completes the word.
+   * @brief Removes a node or node path that completes the word.
    * Returns true if node or node path was deleted successfully.
    * If the final node is a word, it will be deleted.
    * If the final node has children, it will only be deactivated via is_word.
    * If the final node has only one child left, they will be merged.
    *
-   * Space complexity:  O(n); n is the size of the recursion stack.
+   * Space complexity:  O(h); h is the height of the trie.
    * Time complexity:   O(n); n is the length of the word.
    *
    * @param word        The string to be deleted.
    * @return            True if deletion or deactivation was successful, else
    *                    false.
+   * @throws            std::logic_error if the trie is frozen.
    */
-  bool remove(const std::string &word) { return _remove(_root, word, 0); }
+  bool remove(std::string_view word) {
+    RADIX_TRIE_TIME(remove);
+    _check_mutable();
+    if (!_remove(word))
+      return false;
+    _filter_note_removal();
+    return true;
+  }
 
   /**
    * @brief Finds all completions for a given prefix that form a word.
@@ -238,187 +663,1969 @@ public:
    */
   void complete(const std::string &pref,
                 std::vector<std::string> &out_vec) const {
-    Radix_Node *curr = _root;
-    size_t pref_idx = 0;
-
-    while (pref_idx < pref.size()) {
-      char c = pref[pref_idx];
-      if (!curr->children.contains(c)) {
-        return;
-      }
-
-      curr = curr->children[c];
-      std::string &curr_val = curr->val;
-
-      size_t match_len = 0;
-      while (match_len < curr_val.size() && pref_idx < pref.size() &&
-             curr_val[match_len] == pref[pref_idx]) {
-        match_len++;
-        pref_idx++;
-      }
-
-      if (match_len < curr_val.size()) {
-        if (pref_idx == pref.size()) {
-          _complete(curr, out_vec, curr_val.substr(match_len));
-        }
-        return;
-      }
-    }
-
-    _complete(curr, out_vec, "");
+    RADIX_TRIE_TIME(complete);
+    [[maybe_unused]] size_t before = out_vec.size();
+    auto start = _descend(pref);
+    if (start)
+      _complete(start->first, out_vec, std::move(start->second));
+    RADIX_TRIE_RECORD(complete_results, out_vec.size() - before);
   }
 
-private:
   /**
-   * @brief The root node of the trie.
+   * @brief Finds all completions for a given prefix on several worker
+   * threads. Completions are returned in the same order as complete().
+   *
+   * The subtree below the prefix is split at its highest-fanout nodes into
+   * tasks. Each worker writes into its own buffer, and the buffers are
+   * concatenated in task order.
+   *
+   * Space complexity:  O(n); n is the size of the out_vec.
+   * Time complexity:   O(n + h/t); n is the size of the prefix, h is number of
+   *                    nodes in the relevant subtree, t is the number of
+   *                    threads.
+   *
+   * @param pref        A string that needs to be completed.
+   * @param out_vec     A vector of strings that should be populated with
+   *                    completions.
+   * @param n_threads   Number of worker threads. Default is the number of
+   *                    hardware threads.
    */
-  Radix_Node *_root;
+  void
+  complete_parallel(const std::string &pref, std::vector<std::string> &out_vec,
+                    size_t n_threads = std::thread::hardware_concurrency()) const {
+    RADIX_TRIE_TIME(complete);
+    [[maybe_unused]] size_t before = out_vec.size();
+    std::vector<_Complete_Task> tasks = _split_complete(pref, n_threads);
+    std::vector<std::vector<std::string>> buffers(tasks.size());
+
+    _parallel_for(tasks.size(), n_threads, [&](size_t i) {
+      if (tasks[i].node)
+        _complete(tasks[i].node, buffers[i], tasks[i].base);
+      else
+        buffers[i].push_back(std::move(tasks[i].base));
+    });
+
+    for (auto &buffer : buffers)
+      std::ranges::move(buffer, std::back_inserter(out_vec));
+    RADIX_TRIE_RECORD(complete_results, out_vec.size() - before);
+  }
 
   /**
-   * @brief Recursively prints all full words in the trie.
+   * @brief Finds all completions for a given prefix on several worker
+   * threads, streaming them unordered.
    *
-   * Space complexity:  O(n); n is the tree height.
-   * Time complexity:   O(n); n is the number of nodes.
+   * Each worker collects the completions of one task into its own buffer and
+   * hands the whole buffer to the sink once the task is done. Calls to the
+   * sink are serialized, but arrive in no particular order. The latency
+   * recorded by the instrumentation includes the time spent in the sink.
+   *
+   * Space complexity:  O(b); b is the size of the largest task buffer.
+   * Time complexity:   O(n + h/t); n is the size of the prefix, h is number of
+   *                    nodes in the relevant subtree, t is the number of
+   *                    threads.
    *
-   * @param curr        Current node being visited.
-   * @param base        Accumulated prefix string.
+   * @param pref        A string that needs to be completed.
+   * @param sink        Callable invoked with each std::vector<std::string>&&
+   *                    batch of completions.
+   * @param n_threads   Number of worker threads. Default is the number of
+   *                    hardware threads.
    */
-  void _print_list(const Radix_Node *curr, const std::string &base) const {
-    if (curr->is_word)
-      std::cout << base << '\n';
+  template <typename F>
+    requires std::invocable<F &, std::vector<std::string> &&>
+  void
+  complete_parallel(const std::string &pref, F &&sink,
+                    size_t n_threads = std::thread::hardware_concurrency()) const {
+    RADIX_TRIE_TIME(complete);
+    [[maybe_unused]] size_t results = 0;
+    std::vector<_Complete_Task> tasks = _split_complete(pref, n_threads);
+    std::vector<std::string> words;
+    std::erase_if(tasks, [&words](_Complete_Task &task) {
+      if (task.node)
+        return false;
+      words.push_back(std::move(task.base));
+      return true;
+    });
 
-    if (curr->children.empty())
-      return;
+    std::mutex sink_mtx;
+    results = words.size();
+    if (!words.empty())
+      sink(std::move(words));
 
-    for (const auto &entry : curr->children) {
-      std::string new_base = base + entry.second->val;
-      _print_list(entry.second, new_base);
-    }
+    _parallel_for(tasks.size(), n_threads, [&](size_t i) {
+      std::vector<std::string> buffer;
+      _complete(tasks[i].node, buffer, tasks[i].base);
+      std::lock_guard lock(sink_mtx);
+      results += buffer.size();
+      sink(std::move(buffer));
+    });
+    RADIX_TRIE_RECORD(complete_results, results);
   }
 
   /**
-   * @brief Recursively prints a visual tree structure of the trie in markdown
-   * (MD) format.
-   * '𐄂' means that the node forms a word.
+   * @brief Calls a function on every word, in lexicographic order of the
+   * words, comparing bytes as unsigned.
    *
-   * Space complexity:  O(n); n is the tree height.
-   * Time complexity:   O(n); n is the number of nodes.
+   * Children are visited in the order of their first byte, which each node
+   * sorts on the way down.
    *
-   * @param curr        Current node being visited.
-   * @param base        Indentation or visual prefix.
+   * Space complexity:  O(h*k); h is the height of the trie, k is the largest
+   *                    fanout.
+   * Time complexity:   O(n*log(k)); n is the number of nodes.
+   *
+   * @param visit       Callable invoked with each word as std::string_view.
+   *                    The view is valid during the call only.
    */
-  void _print_md(const Radix_Node *curr, const std::string &base) const {
-    if (curr->is_word)
-      std::cout << std::format("{} {} 𐄂", base, curr->val) << std::endl;
-    else
-      std::cout << std::format("{} {}", base, curr->val) << std::endl;
+  template <typename F>
+    requires std::invocable<F &, std::string_view>
+  void for_each(F &&visit) const {
+    struct Frame {
+      const Radix_Node *node;
+      size_t path_size;
+    };
+    std::vector<Frame> stack{{_root, 0}};
+    std::vector<const Radix_Node *> children;
+    std::string path;
 
-    if (curr->children.empty())
-      return;
+    while (!stack.empty()) {
+      auto [node, path_size] = stack.back();
+      stack.pop_back();
+      path.resize(path_size);
+      path += node->val;
+      if (node->is_word)
+        visit(std::string_view(path));
 
-    for (const auto &entry : curr->children) {
-      std::string new_base = "#" + base;
-      _print_md(entry.second, new_base);
+      children.clear();
+      for (const auto &entry : node->children)
+        children.push_back(entry.second);
+      std::ranges::sort(children, std::ranges::greater(),
+                        [](const Radix_Node *child) {
+                          return static_cast<unsigned char>(child->val[0]);
+                        });
+      for (const Radix_Node *child : children)
+        stack.push_back({child, path.size()});
     }
   }
 
   /**
-   * @brief Helper to rebind a node during insertion when a prefix match splits.
+   * @brief Finds all completions for many prefixes at once. Each prefix gets
+   * the same completions, in the same order, as complete() gives it.
    *
-   * Space complexity:      O(1).
-   * Time complexity:       O(1).
+   * The prefixes are sorted, so each descent resumes from the nodes shared
+   * with the previous prefix instead of the root. A prefix that extends an
+   * earlier one in the batch is not enumerated again: its completions are
+   * cut from the range of the earlier prefix's completions that lies below
+   * its node, recorded while the earlier subtree is walked.
    *
-   * @param common_node     New intermediate node representing the shared
-   *                        prefix.
-   * @param prev            Parent of the node being split.
-   * @param curr            Node being split and moved under common_node.
-   * @param curr            Index at which to split curr_node's val.
+   * The instrumentation records the batch as one completion: its latency
+   * and its total number of results.
+   *
+   * Space complexity:  O(n + h); n is the total size of the out_vecs, h is
+   *                    the height of the trie.
+   * Time complexity:   O(p*log(p) + l + s + n); p is the number of prefixes,
+   *                    l is their total length, s is the number of nodes in
+   *                    the subtrees of prefixes not extending another one.
+   *
+   * @param prefixes    Strings that need to be completed.
+   * @param out_vecs    Resized to one vector per prefix, each populated with
+   *                    the completions of the prefix at the same index.
    */
-  inline void _rebind(Radix_Node *common, Radix_Node *prev, Radix_Node *curr,
-                      size_t curr_idx) {
-    common->children[curr->val[curr_idx]] = curr;
-    prev->children[curr->val[0]] = common;
-    curr->val = curr->val.substr(curr_idx, curr->val.size());
+  void complete_batch(const std::vector<std::string> &prefixes,
+                      std::vector<std::vector<std::string>> &out_vecs) const {
+    RADIX_TRIE_TIME(complete);
+    auto total_size = [&out_vecs] {
+      size_t total = 0;
+      for (const auto &out_vec : out_vecs)
+        total += out_vec.size();
+      return total;
+    };
+    out_vecs.resize(prefixes.size());
+    [[maybe_unused]] size_t before = total_size();
+    std::vector<size_t> order(prefixes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::stable_sort(order, {}, [&prefixes](size_t i) {
+      return std::string_view(prefixes[i]);
+    });
+
+    std::vector<_Batch_Frame> path{{_root, 0}};
+    std::string_view prev;
+    std::unordered_map<const Radix_Node *, std::vector<size_t>> nested;
+
+    for (size_t group = 0; group < order.size();) {
+      const std::string &outer = prefixes[order[group]];
+      size_t group_end = group + 1;
+      while (group_end < order.size() &&
+             prefixes[order[group_end]].starts_with(outer))
+        group_end++;
+
+      nested.clear();
+      auto start = _descend_from(path, prev, outer);
+      prev = outer;
+      for (size_t i = group + 1; start && i < group_end; i++) {
+        auto found = _descend_from(path, prev, prefixes[order[i]]);
+        prev = prefixes[order[i]];
+        if (found)
+          nested[found->first].push_back(order[i]);
+      }
+
+      if (start)
+        _complete_nested(start->first, std::move(start->second), outer,
+                         nested, prefixes, out_vecs, out_vecs[order[group]]);
+      group = group_end;
+    }
+    RADIX_TRIE_RECORD(complete_results, total_size() - before);
   }
 
   /**
-   * @brief Recursively removes a word from a Radix Tree.
+   * @brief Writes the trie to a stream in a compact binary format.
    *
-   * Handles both full node deletions (when a node becomes unnecessary) and
-   * logical deletions (by marking the `is_word` flag as false). The method also
-   * compresses nodes when appropriate (i.e., merges a node with its single
-   * child after deletion, if the resulting node no longer represents a word).
+   * The format is a header (magic "RDXT" and a 32-bit little-endian version)
+   * followed by every node in preorder. Each node is stored as a varint label
+   * length, the label bytes and a varint holding its child count shifted left
+   * by one, with the word flag in the lowest bit. Children are keyed by the
+   * first byte of their label, so no child table is needed beyond the count.
    *
-   * Space complexity:  O(n); n is the size of the recursion stack.
-   * Time complexity:   O(n); n is the length of the word.
+   * Space complexity:  O(h); h is the height of the trie.
+   * Time complexity:   O(n); n is the number of nodes.
    *
-   * @param curr        Pointer to the current node being examined.
-   * @param word        The word to be removed from the Radix Tree.
-   * @param word_idx    The current index in the word being matched against
-   *                    nodes.
-   * @return            True if node was removed or deactivated.
+   * @param os          The stream to write to.
+   * @throws            std::runtime_error if writing fails.
    */
-  bool _remove(Radix_Node *curr, const std::string &word, size_t word_idx) {
-    if (!curr)
-      return false;
+  void save(std::ostream &os) const {
+    std::string buf(_format_magic);
+    _put_u32(buf, _format_version);
 
-    if (word_idx == word.length()) {
-      if (!curr->is_word)
-        return false;
-      curr->is_word = false;
-    } else {
-      char c = word[word_idx];
-      if (!curr->children.contains(c))
-        return false;
+    std::vector<const Radix_Node *> stack{_root};
+    while (!stack.empty()) {
+      const Radix_Node *curr = stack.back();
+      stack.pop_back();
 
-      Radix_Node *child = curr->children[c];
-      if (!_remove(child, word, word_idx + child->val.length()))
-        return false;
+      put_varint(buf, curr->val.size());
+      buf += curr->val;
+      put_varint(buf, (curr->children.size() << 1) | curr->is_word);
+      for (const auto &entry : curr->children)
+        stack.push_back(entry.second);
 
-      if (!child->is_word && child->children.empty()) {
-        delete child;
-        curr->children.erase(c);
-      } else if (!child->is_word && child->children.size() == 1) {
-        auto &grandchild_entry = *child->children.begin();
-        Radix_Node *grandchild = grandchild_entry.second;
-        child->val += grandchild->val;
-        child->is_word = grandchild->is_word;
-        child->children = std::move(grandchild->children);
-        delete grandchild;
+      if (buf.size() >= _io_chunk_size) {
+        os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        buf.clear();
       }
     }
 
-    return true;
+    os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+    if (!os)
+      throw std::runtime_error("Failed to write radix trie.");
   }
 
   /**
-   * @brief Recursively collects all complete words under the given node.
+   * @brief Writes the trie to a file. See save(std::ostream &).
    *
-   * The method ensures that only valid, complete words are added to the
-   * completion list, excluding internal path segments that do not terminate
+   * @param path        The file to write to. It is overwritten.
+   * @throws            std::runtime_error if the file cannot be written.
+   */
+  void save(const std::filesystem::path &path) const {
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    if (!os)
+      throw std::runtime_error(
+          std::format("Failed to open \"{}\" for writing.", path.string()));
+    save(os);
+  }
+
+  /**
+   * @brief Replaces the content of the trie with one written by save().
+   *
+   * The whole stream is read in one sequential pass and nodes are rebuilt in
+   * preorder, with child tables sized up front. No word is re-inserted, so
+   * no node is ever split. The loaded trie counts as checkpointed, see
+   * checkpoint_delta(). A frozen trie is thawed, since its content is
+   * replaced. On error the trie is left unchanged.
+   *
+   * Space complexity:  O(s); s is the size of the serialized trie.
+   * Time complexity:   O(n); n is the number of nodes.
+   *
+   * @param is          The stream to read from.
+   * @throws            std::runtime_error if the data is not a valid trie.
+   */
+  void load(std::istream &is) {
+    std::string data = _read_all(is);
+    const char *pos = data.data();
+    const char *end = pos + data.size();
+    if (data.size() < _format_magic.size() + 4 ||
+        std::string_view(pos, _format_magic.size()) != _format_magic)
+      throw std::runtime_error("Not a radix trie: bad magic.");
+    pos += _format_magic.size();
+
+    uint32_t version = _get_u32(pos);
+    if (version != _format_version)
+      throw std::runtime_error(
+          std::format("Unsupported radix trie format version {}.", version));
+
+    // Each frame is a node still waiting for this many children.
+    std::vector<std::pair<Radix_Node *, uint64_t>> stack;
+    std::unique_ptr<Radix_Node> root;
+    size_t height = 1;
+    _Footprint footprint;
+    do {
+      uint64_t label_size = get_varint(pos, end);
+      if (label_size > static_cast<uint64_t>(end - pos))
+        throw std::runtime_error("Truncated radix trie label.");
+
+      auto node = std::make_unique<Radix_Node>(
+          std::string(pos, label_size), false);
+      node->is_dirty = false;
+      pos += label_size;
+
+      uint64_t header = get_varint(pos, end);
+      node->is_word = header & 1;
+      node->children.reserve(_checked_child_count(header));
+
+      Radix_Node *raw = node.get();
+      footprint += _Footprint::of(raw);
+      if (!root) {
+        root = std::move(node);
+      } else {
+        if (raw->val.empty())
+          throw std::runtime_error("Empty label on a non-root node.");
+        auto &parent = stack.back();
+        footprint -= _Footprint::of(parent.first);
+        if (!parent.first->children.emplace(raw->val[0], raw).second)
+          throw std::runtime_error("Duplicate child in radix trie.");
+        footprint += _Footprint::of(parent.first);
+        node.release();
+        parent.second--;
+      }
+
+      while (!stack.empty() && stack.back().second == 0)
+        stack.pop_back();
+      if (header >> 1)
+        stack.emplace_back(raw, header >> 1);
+      height = std::max(height, stack.size() + 1);
+    } while (!stack.empty());
+
+    if (pos != end)
+      throw std::runtime_error("Trailing data after radix trie.");
+
+    _delete_nodes();
+    _root = root.release();
+    _footprint = footprint;
+    _frozen = false;
+    _height_hint.store(height, std::memory_order_relaxed);
+    _rebuild_filter();
+  }
+
+  /**
+   * @brief Replaces the content of the trie with a file written by save().
+   * See load(std::istream &).
+   *
+   * @param path        The file to read from.
+   * @throws            std::runtime_error if the file cannot be read or is
+   *                    not a valid trie.
+   */
+  void load(const std::filesystem::path &path) {
+    std::ifstream is(path, std::ios::binary);
+    if (!is)
+      throw std::runtime_error(
+          std::format("Failed to open \"{}\" for reading.", path.string()));
+    load(is);
+  }
+
+  /**
+   * @brief Writes a full snapshot, as save() does, and starts tracking
+   * changes against it.
+   *
+   * Space complexity:  O(h); h is the height of the trie.
+   * Time complexity:   O(n); n is the number of nodes.
+   *
+   * @param os          The stream to write to.
+   * @throws            std::runtime_error if writing fails.
+   */
+  void checkpoint(std::ostream &os) {
+    save(os);
+    _clear_dirty();
+  }
+
+  /**
+   * @brief Writes only the parts of the trie that changed since the last
+   * checkpoint, then starts tracking changes against the new state.
+   *
+   * Every node touched by insert or remove is marked dirty together with its
+   * ancestors. The delta (magic "RDXD" and a 32-bit little-endian version)
+   * lists the dirty nodes in preorder. A dirty node is a tag byte 1, a varint
+   * label length, the label and a varint holding its child count shifted
+   * left by one, with the word flag in the lowest bit, followed by its
+   * children. A clean child is a tag byte 0, a varint label length and the
+   * label; it stands for the unchanged subtree that ends at the same path in
+   * the previous state.
+   *
+   * Space complexity:  O(d); d is the number of dirty nodes.
+   * Time complexity:   O(d); d is the number of dirty nodes.
+   *
+   * @param os          The stream to write to.
+   * @throws            std::runtime_error if writing fails.
+   */
+  void checkpoint_delta(std::ostream &os) {
+    std::string buf(_delta_magic);
+    _put_u32(buf, _format_version);
+
+    std::vector<const Radix_Node *> stack{_root};
+    while (!stack.empty()) {
+      const Radix_Node *curr = stack.back();
+      stack.pop_back();
+
+      buf.push_back(curr->is_dirty ? _delta_dirty : _delta_clean);
+      put_varint(buf, curr->val.size());
+      buf += curr->val;
+      if (curr->is_dirty) {
+        put_varint(buf, (curr->children.size() << 1) | curr->is_word);
+        for (const auto &entry : curr->children)
+          stack.push_back(entry.second);
+      }
+
+      if (buf.size() >= _io_chunk_size) {
+        os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        buf.clear();
+      }
+    }
+
+    os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+    if (!os)
+      throw std::runtime_error("Failed to write radix trie delta.");
+    _clear_dirty();
+  }
+
+  /**
+   * @brief Applies a delta written by checkpoint_delta() onto the trie.
+   *
+   * The trie must hold the state the delta was taken against: the base
+   * snapshot followed by every earlier delta of the chain. Unchanged
+   * subtrees are moved over from the current trie, so the cost grows with
+   * the size of the delta, not of the trie. On error the trie is left
+   * unchanged.
+   *
+   * Space complexity:  O(d); d is the size of the delta.
+   * Time complexity:   O(d*l); d is the size of the delta, l is the length
+   *                    of the longest key.
+   *
+   * @param is          The stream to read from.
+   * @throws            std::runtime_error if the data is not a valid delta
+   *                    or does not match the trie.
+   * @throws            std::logic_error if the trie is frozen.
+   */
+  void apply_delta(std::istream &is) {
+    _check_mutable();
+    std::string data = _read_all(is);
+    const char *pos = data.data();
+    const char *end = pos + data.size();
+    if (data.size() < _delta_magic.size() + 4 ||
+        std::string_view(pos, _delta_magic.size()) != _delta_magic)
+      throw std::runtime_error("Not a radix trie delta: bad magic.");
+    pos += _delta_magic.size();
+
+    uint32_t version = _get_u32(pos);
+    if (version != _format_version)
+      throw std::runtime_error(
+          std::format("Unsupported radix trie delta version {}.", version));
+
+    // A clean subtree to move: its slot in the new trie and its place in the
+    // current one.
+    struct Reuse {
+      Radix_Node *new_parent;
+      Radix_Node *old_parent;
+      char key;
+    };
+    std::vector<Reuse> reused;
+
+    // Each frame is a new node still waiting for this many children, and the
+    // length of its full path.
+    std::vector<std::tuple<Radix_Node *, uint64_t, size_t>> stack;
+    std::unique_ptr<Radix_Node> root;
+    std::string path;
+    _Footprint added;
+    do {
+      if (pos == end)
+        throw std::runtime_error("Truncated radix trie delta.");
+      char tag = *pos++;
+      uint64_t label_size = get_varint(pos, end);
+      if (label_size > static_cast<uint64_t>(end - pos))
+        throw std::runtime_error("Truncated radix trie label.");
+      std::string_view label(pos, label_size);
+      pos += label_size;
+
+      if (!stack.empty()) {
+        path.resize(std::get<2>(stack.back()));
+        std::get<1>(stack.back())--;
+      }
+      path += label;
+      if (!root && tag == _delta_clean)
+        return;
+      if (root && label.empty())
+        throw std::runtime_error("Empty label on a non-root node.");
+
+      if (tag == _delta_clean) {
+        auto [old_parent, old_node] = _locate(path);
+        Radix_Node *parent = std::get<0>(stack.back());
+        added -= _Footprint::of(parent);
+        if (!old_node || old_node->val != label ||
+            !parent->children.emplace(label[0], nullptr).second)
+          throw std::runtime_error("Radix trie delta does not match trie.");
+        added += _Footprint::of(parent);
+        reused.push_back({parent, old_parent, label[0]});
+      } else if (tag == _delta_dirty) {
+        auto node = std::make_unique<Radix_Node>(std::string(label), false);
+        node->is_dirty = false;
+        uint64_t header = get_varint(pos, end);
+        node->is_word = header & 1;
+        node->children.reserve(_checked_child_count(header));
+
+        Radix_Node *raw = node.get();
+        added += _Footprint::of(raw);
+        if (!root) {
+          root = std::move(node);
+        } else {
+          Radix_Node *parent = std::get<0>(stack.back());
+          added -= _Footprint::of(parent);
+          if (!parent->children.emplace(label[0], raw).second)
+            throw std::runtime_error("Duplicate child in radix trie delta.");
+          added += _Footprint::of(parent);
+          node.release();
+        }
+        if (header >> 1)
+          stack.emplace_back(raw, header >> 1, path.size());
+      } else {
+        throw std::runtime_error("Bad tag in radix trie delta.");
+      }
+
+      while (!stack.empty() && std::get<1>(stack.back()) == 0)
+        stack.pop_back();
+    } while (!stack.empty());
+
+    if (pos != end)
+      throw std::runtime_error("Trailing data after radix trie delta.");
+
+    for (const Reuse &entry : reused) {
+      auto it = entry.old_parent->children.find(entry.key);
+      entry.new_parent->children[entry.key] = it->second;
+      _footprint -= _Footprint::of(entry.old_parent);
+      entry.old_parent->children.erase(it);
+      _footprint += _Footprint::of(entry.old_parent);
+    }
+
+    // What is left of the current trie is freed; the reused subtrees keep
+    // their share of the counters.
+    _footprint -= _Footprint::of_subtree(_root);
+    _footprint += added;
+    delete _root;
+    _root = root.release();
+    _rebuild_filter();
+  }
+
+  /**
+   * @brief Turns the trie into a minimal acyclic automaton (DAWG) by
+   * sharing identical subtrees, for dictionaries that no longer change.
+   *
+   * Nodes are visited in postorder. A node whose label, word flag, dirty
+   * flag and children equal those of a node seen before is replaced by it
+   * and freed, so common suffixes such as "ation" or "ing" are stored once.
+   * Since children are already shared when their parent is visited,
+   * comparing child pointers is enough. Only equally dirty nodes are merged,
+   * so checkpoint_delta() still writes every changed path.
+   *
+   * Lookups, completions, printing and save() work unchanged; save() writes
+   * shared subtrees once per path, so the result loads as a plain trie. A
+   * frozen trie cannot be modified, except by load().
+   *
+   * Space complexity:  O(n); n is the number of nodes.
+   * Time complexity:   O(n + s); s is the total size of the labels.
+   */
+  void freeze() {
+    if (_frozen)
+      return;
+
+    std::unordered_map<std::string, Radix_Node *> canonical;
+    std::string signature;
+    std::vector<std::pair<char, Radix_Node *>> children;
+
+    using Iter = std::unordered_map<char, Radix_Node *>::iterator;
+    std::vector<std::pair<Radix_Node *, Iter>> stack{
+        {_root, _root->children.begin()}};
+    while (stack.size() > 1 || stack.back().second != _root->children.end()) {
+      auto &[node, it] = stack.back();
+      if (it != node->children.end()) {
+        Radix_Node *child = (it++)->second;
+        stack.emplace_back(child, child->children.begin());
+        continue;
+      }
+
+      children.assign(node->children.begin(), node->children.end());
+      std::ranges::sort(children);
+      signature.assign(1, static_cast<char>(node->is_word |
+                                            node->is_dirty << 1));
+      put_varint(signature, node->val.size());
+      signature += node->val;
+      for (auto [c, child] : children) {
+        signature.push_back(c);
+        signature.append(reinterpret_cast<const char *>(&child),
+                         sizeof(child));
+      }
+
+      Radix_Node *done = node;
+      stack.pop_back();
+      auto [entry, added] = canonical.try_emplace(signature, done);
+      if (!added) {
+        stack.back().first->children[done->val[0]] = entry->second;
+        _footprint -= _Footprint::of(done);
+        // Its children are shared with the node it duplicates.
+        done->children.clear();
+        delete done;
+      }
+    }
+
+    _frozen = true;
+  }
+
+  /**
+   * @brief Checks whether the trie was frozen by freeze().
+   */
+  bool is_frozen() const { return _frozen; }
+
+private:
+  friend class Completion_Session;
+
+  /**
+   * @brief The root node of the trie.
+   */
+  Radix_Node *_root;
+
+  /**
+   * @brief Largest number of nodes seen on one root-to-leaf path, used to
+   * size traversal stacks up front. Inserts and traversals raise it, and it
+   * is not lowered on removal, so it is a hint: stacks still grow past it.
+   */
+  mutable std::atomic<size_t> _height_hint = 1;
+
+  /**
+   * @brief Whether nodes are shared, see freeze().
+   */
+  bool _frozen = false;
+
+  /**
+   * @brief Optional Bloom filter of the words, see enable_filter().
+   */
+  std::unique_ptr<Blocked_Bloom_Filter> _filter;
+  double _filter_bits_per_key = 10;
+
+  /**
+   * @brief Words added to the filter, and words removed from the trie since
+   * it was built.
+   */
+  size_t _filter_keys = 0;
+  size_t _filter_removed = 0;
+
+  /**
+   * @brief Smallest number of words a filter is sized for.
+   */
+  static constexpr size_t _filter_min_keys = 1024;
+
+  /**
+   * @brief A level of a depth-first walk: a node, its next child to visit
+   * and the length of the path up to and including the node.
+   */
+  struct _Walk_Frame {
+    const Radix_Node *node;
+    std::unordered_map<char, Radix_Node *>::const_iterator next;
+    size_t path_size;
+  };
+
+  /**
+   * @brief A node on the path of the last prefix descended by
+   * complete_batch(), and the prefix length at the end of its label.
+   */
+  struct _Batch_Frame {
+    const Radix_Node *node;
+    size_t end;
+  };
+
+  /**
+   * @brief A unit of parallel completion work. Either a subtree to complete
+   * below base, or, if node is nullptr, a single completion held in base.
+   */
+  struct _Complete_Task {
+    const Radix_Node *node;
+    std::string base;
+  };
+
+  /**
+   * @brief Capacity of the small-string buffer; longer labels live on the
+   * heap.
+   */
+  static inline const size_t _sso_capacity = std::string().capacity();
+
+  /**
+   * @brief Size of a child map entry: a next pointer and the key-value pair.
+   */
+  static constexpr size_t _map_entry_size =
+      sizeof(void *) + sizeof(std::pair<const char, Radix_Node *>);
+
+  /**
+   * @brief Bytes spent on nodes, as reported by memory_usage(), without the
+   * filter and the histograms.
+   */
+  struct _Footprint {
+    size_t nodes = 0;
+    size_t child_containers = 0;
+    size_t labels = 0;
+    size_t allocator_overhead = 0;
+    size_t node_count = 0;
+
+    /**
+     * @brief Estimated glibc malloc header and rounding of an allocation.
+     */
+    static size_t overhead(size_t size) {
+      return std::max<size_t>(32, (size + 8 + 15) & ~size_t{15}) - size;
+    }
+
+    /**
+     * @brief The node object, its label buffer and its child map.
+     */
+    static _Footprint of(const Radix_Node *node) {
+      _Footprint fp;
+      auto add = [&fp](size_t &field, size_t size, size_t count) {
+        field += size * count;
+        fp.allocator_overhead += overhead(size) * count;
+      };
+
+      fp.node_count = 1;
+      add(fp.nodes, sizeof(Radix_Node), 1);
+      if (node->val.capacity() > _sso_capacity)
+        add(fp.labels, node->val.capacity() + 1, 1);
+      // A map with a single bucket keeps it inline in the map object.
+      if (node->children.bucket_count() > 1)
+        add(fp.child_containers,
+            node->children.bucket_count() * sizeof(void *), 1);
+      add(fp.child_containers, _map_entry_size, node->children.size());
+      return fp;
+    }
+
+    /**
+     * @brief Every node of an unshared subtree.
+     */
+    static _Footprint of_subtree(const Radix_Node *root) {
+      _Footprint fp;
+      std::vector<const Radix_Node *> stack{root};
+      while (!stack.empty()) {
+        const Radix_Node *curr = stack.back();
+        stack.pop_back();
+        fp += of(curr);
+        for (const auto &entry : curr->children)
+          stack.push_back(entry.second);
+      }
+      return fp;
+    }
+
+    // Fields are unsigned, so a partial sum may wrap around while nodes
+    // are reshaped; the total comes out right once every change is in.
+    _Footprint &operator+=(const _Footprint &other) {
+      nodes += other.nodes;
+      child_containers += other.child_containers;
+      labels += other.labels;
+      allocator_overhead += other.allocator_overhead;
+      node_count += other.node_count;
+      return *this;
+    }
+
+    _Footprint &operator-=(const _Footprint &other) {
+      nodes -= other.nodes;
+      child_containers -= other.child_containers;
+      labels -= other.labels;
+      allocator_overhead -= other.allocator_overhead;
+      node_count -= other.node_count;
+      return *this;
+    }
+  };
+
+  /**
+   * @brief Running totals behind memory_usage(). Every operation that adds,
+   * frees or reshapes a node subtracts the node's footprint before the
+   * change and adds it back after.
+   */
+  _Footprint _footprint;
+
+  /**
+   * @brief Magic bytes that open the binary format of save().
+   */
+  static constexpr std::string_view _format_magic = "RDXT";
+
+  /**
+   * @brief Version of the binary format of save().
+   */
+  static constexpr uint32_t _format_version = 1;
+
+  /**
+   * @brief Size of the blocks used for binary reads and writes.
+   */
+  static constexpr size_t _io_chunk_size = 1 << 16;
+
+  /**
+   * @brief Returns the child count of a node header read from a file, after
+   * checking that it fits the 256 possible first bytes, so a corrupt count
+   * cannot reserve a huge child table.
+   *
+   * @throws            std::runtime_error if the count is larger than 256.
+   */
+  static size_t _checked_child_count(uint64_t header) {
+    if ((header >> 1) > 256)
+      throw std::runtime_error(std::format(
+          "Invalid child count {} in radix trie. It must be at most 256.",
+          header >> 1));
+    return static_cast<size_t>(header >> 1);
+  }
+
+  /**
+   * @brief Magic bytes that open the delta format of checkpoint_delta().
+   */
+  static constexpr std::string_view _delta_magic = "RDXD";
+
+  /**
+   * @brief Tags of the node records in a delta.
+   */
+  static constexpr char _delta_clean = 0;
+  static constexpr char _delta_dirty = 1;
+
+  /**
+   * @brief Reads a whole stream into memory in large blocks.
+   */
+  static std::string _read_all(std::istream &is) {
+    std::string data;
+    std::vector<char> chunk(_io_chunk_size);
+    while (is.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) ||
+           is.gcount() > 0)
+      data.append(chunk.data(), static_cast<size_t>(is.gcount()));
+    return data;
+  }
+
+  /**
+   * @brief Clears the dirty flags. Only dirty nodes are visited, since a
+   * clean node never has dirty descendants.
+   */
+  void _clear_dirty() {
+    std::vector<Radix_Node *> stack{_root};
+    while (!stack.empty()) {
+      Radix_Node *curr = stack.back();
+      stack.pop_back();
+      if (!curr->is_dirty)
+        continue;
+
+      curr->is_dirty = false;
+      for (const auto &entry : curr->children)
+        stack.push_back(entry.second);
+    }
+  }
+
+  /**
+   * @brief Finds the node whose full path is exactly a given string.
+   *
+   * @param path        The full path of the node.
+   * @return            The parent and the node, or nullptrs if no node ends
+   *                    exactly there. The root has no parent.
+   */
+  std::pair<Radix_Node *, Radix_Node *> _locate(std::string_view path) const {
+    Radix_Node *parent = nullptr;
+    Radix_Node *curr = _root;
+    size_t path_idx = 0;
+
+    while (path_idx < path.size()) {
+      auto it = curr->children.find(path[path_idx]);
+      if (it == curr->children.end() ||
+          path.compare(path_idx, it->second->val.size(), it->second->val) != 0)
+        return {nullptr, nullptr};
+
+      parent = curr;
+      curr = it->second;
+      path_idx += curr->val.size();
+    }
+
+    return {parent, curr};
+  }
+
+  /**
+   * @brief Throws if the trie is frozen.
+   */
+  void _check_mutable() const {
+    if (_frozen)
+      throw std::logic_error("The trie is frozen and cannot be modified.");
+  }
+
+  /**
+   * @brief Frees every node. Nodes shared by a frozen trie are collected
+   * first and freed once each.
+   */
+  void _delete_nodes() {
+    if (!_frozen) {
+      delete _root;
+      return;
+    }
+
+    std::unordered_set<Radix_Node *> nodes{_root};
+    std::vector<Radix_Node *> stack{_root};
+    while (!stack.empty()) {
+      Radix_Node *curr = stack.back();
+      stack.pop_back();
+      for (const auto &entry : curr->children)
+        if (nodes.insert(entry.second).second)
+          stack.push_back(entry.second);
+    }
+
+    for (Radix_Node *node : nodes) {
+      node->children.clear();
+      delete node;
+    }
+  }
+
+  /**
+   * @brief Appends a 32-bit little-endian integer to a buffer.
+   */
+  static void _put_u32(std::string &out, uint32_t val) {
+    for (int i = 0; i < 4; i++)
+      out.push_back(static_cast<char>(val >> (8 * i)));
+  }
+
+  /**
+   * @brief Reads a 32-bit little-endian integer and advances the cursor. The
+   * caller checks that 4 bytes are available.
+   */
+  static uint32_t _get_u32(const char *&pos) {
+    uint32_t val = 0;
+    for (int i = 0; i < 4; i++)
+      val |= static_cast<uint32_t>(static_cast<unsigned char>(*pos++))
+             << (8 * i);
+    return val;
+  }
+
+  /**
+   * @brief Number of tasks created per worker thread, so uneven subtrees
+   * still balance out.
+   */
+  static constexpr size_t _tasks_per_thread = 8;
+
+  /**
+   * @brief Walks down the trie along a prefix.
+   *
+   * Space complexity:  O(1).
+   * Time complexity:   O(n); n is the length of the prefix.
+   *
+   * @param pref        The prefix to follow.
+   * @return            The node whose path covers the prefix, together with
+   *                    the unmatched rest of its label, or std::nullopt if no
+   *                    stored path starts with the prefix.
+   */
+  std::optional<std::pair<const Radix_Node *, std::string>>
+  _descend(const std::string &pref) const {
+    const Radix_Node *curr = _root;
+    size_t pref_idx = 0;
+
+    while (pref_idx < pref.size()) {
+      auto it = curr->children.find(pref[pref_idx]);
+      if (it == curr->children.end())
+        return {};
+
+      curr = it->second;
+      const std::string &curr_val = curr->val;
+      RADIX_TRIE_COUNT(nodes_visited, 1);
+
+      size_t match_len =
+          mismatch(curr_val.data(), pref.data() + pref_idx,
+                   std::min(curr_val.size(), pref.size() - pref_idx));
+      pref_idx += match_len;
+      RADIX_TRIE_COUNT(bytes_compared, match_len);
+
+      if (match_len < curr_val.size()) {
+        if (pref_idx == pref.size())
+          return std::pair{curr, curr_val.substr(match_len)};
+        return {};
+      }
+    }
+
+    return std::pair{curr, std::string{}};
+  }
+
+  /**
+   * @brief Walks down the trie along a prefix, resuming from the nodes the
+   * previous prefix shares with it.
+   *
+   * Space complexity:  O(1).
+   * Time complexity:   O(n - c); n is the length of the prefix, c is the
+   *                    length it shares with the previous one.
+   *
+   * @param path        The nodes on the path of the previous prefix, rooted
+   *                    at the trie root. Updated to the path of this prefix.
+   * @param prev        The previous prefix, or empty for the first one.
+   * @param pref        The prefix to follow.
+   * @return            As _descend().
+   */
+  std::optional<std::pair<const Radix_Node *, std::string>>
+  _descend_from(std::vector<_Batch_Frame> &path, std::string_view prev,
+                std::string_view pref) const {
+    size_t common =
+        mismatch(prev.data(), pref.data(), std::min(prev.size(), pref.size()));
+    while (path.back().end > common)
+      path.pop_back();
+
+    size_t pref_idx = path.back().end;
+    while (pref_idx < pref.size()) {
+      auto it = path.back().node->children.find(pref[pref_idx]);
+      if (it == path.back().node->children.end())
+        return {};
+
+      const Radix_Node *curr = it->second;
+      const std::string &curr_val = curr->val;
+      RADIX_TRIE_COUNT(nodes_visited, 1);
+
+      size_t match_len =
+          mismatch(curr_val.data(), pref.data() + pref_idx,
+                   std::min(curr_val.size(), pref.size() - pref_idx));
+      RADIX_TRIE_COUNT(bytes_compared, match_len);
+
+      if (match_len < curr_val.size()) {
+        if (pref_idx + match_len < pref.size())
+          return {};
+        path.push_back({curr, pref_idx + curr_val.size()});
+        return std::pair{curr, curr_val.substr(match_len)};
+      }
+
+      pref_idx += match_len;
+      path.push_back({curr, pref_idx});
+    }
+
+    return std::pair{path.back().node, std::string{}};
+  }
+
+  /**
+   * @brief Splits the completion of a prefix into tasks, listed in the order
+   * complete() visits them.
+   *
+   * Starting from the whole subtree, the task whose node has the most
+   * children is repeatedly replaced in place by the node's own completion and
+   * one task per child, until there are enough tasks for the workers.
+   *
+   * Space complexity:  O(t); t is the number of tasks.
+   * Time complexity:   O(t^2); t is the number of tasks.
+   *
+   * @param pref        A string that needs to be completed.
+   * @param n_threads   Number of worker threads the tasks are meant for.
+   * @return            The tasks, empty if nothing starts with the prefix.
+   */
+  std::vector<_Complete_Task> _split_complete(const std::string &pref,
+                                              size_t n_threads) const {
+    std::vector<_Complete_Task> tasks;
+    auto start = _descend(pref);
+    if (!start)
+      return tasks;
+
+    tasks.push_back({start->first, std::move(start->second)});
+    size_t target = std::max<size_t>(n_threads, 1) * _tasks_per_thread;
+
+    while (tasks.size() < target) {
+      auto widest = std::ranges::max_element(
+          tasks, {}, [](const _Complete_Task &task) {
+            return task.node ? task.node->children.size() : 0;
+          });
+      if (!widest->node || widest->node->children.size() < 2)
+        break;
+
+      _Complete_Task parent = std::move(*widest);
+      std::vector<_Complete_Task> expanded;
+      if (parent.node->is_word && parent.base != "")
+        expanded.push_back({nullptr, parent.base});
+      for (const auto &entry : parent.node->children)
+        expanded.push_back({entry.second, parent.base + entry.second->val});
+
+      auto pos = tasks.erase(widest);
+      tasks.insert(pos, std::make_move_iterator(expanded.begin()),
+                   std::make_move_iterator(expanded.end()));
+    }
+
+    return tasks;
+  }
+
+  /**
+   * @brief Words grouped by their first character.
+   */
+  using _Partition = std::array<std::vector<std::string_view>, 256>;
+
+  /**
+   * @brief A unit of parallel insertion work: the words to insert below one
+   * child slot of a node. The words share the path of the node, which is
+   * depth bytes long, and the slot's key byte after it.
+   */
+  struct _Insert_Task {
+    Radix_Node *parent;
+    char key;
+    size_t depth;
+    std::vector<std::string_view> words;
+  };
+
+  /**
+   * @brief Size of the blocks read by load_lines(). Lines longer than this
+   * grow the block.
+   */
+  static constexpr size_t _line_block_size = 1 << 20;
+
+  /**
+   * @brief Inserts words that are already grouped by first character on
+   * several worker threads.
+   *
+   * Partitions are split by _split_insert_tasks() until none holds more
+   * than its share of the words. Existing subtrees are detached from their
+   * slots and handed to the worker that owns the slot, then every subtree is
+   * spliced back.
+   *
+   * @param parts       Groups of words, typically one per input slice. The
+   *                    words of a character may be spread over all groups.
+   * @param n_threads   Number of worker threads.
+   */
+  void _insert_partitioned(std::vector<_Partition> parts, size_t n_threads) {
+    std::vector<_Insert_Task> tasks;
+    size_t n_words = 0;
+    for (size_t i = 0; i < std::tuple_size_v<_Partition>; i++) {
+      _Insert_Task task{_root, static_cast<char>(i), 0, std::move(parts[0][i])};
+      for (size_t j = 1; j < parts.size(); j++)
+        task.words.insert(task.words.end(), parts[j][i].begin(),
+                          parts[j][i].end());
+      n_words += task.words.size();
+      if (!task.words.empty())
+        tasks.push_back(std::move(task));
+    }
+    parts.clear();
+
+    if (n_threads > 1)
+      tasks = _split_insert_tasks(
+          std::move(tasks),
+          std::max<size_t>(1, n_words / (n_threads * _tasks_per_thread)),
+          n_threads);
+
+    // Largest partitions first, so stragglers are short.
+    std::ranges::sort(tasks, std::ranges::greater(),
+                      [](const _Insert_Task &task) { return task.words.size(); });
+
+    // Each worker counts its own changes. The local roots are not part of
+    // the trie, so their own footprint is added first and removed last.
+    std::vector<std::unique_ptr<Radix_Node>> locals = _detach_slots(tasks);
+    std::vector<_Footprint> footprints(tasks.size());
+    _parallel_for(tasks.size(), n_threads, [&](size_t i) {
+      Radix_Node *local = locals[i].get();
+      footprints[i] = _Footprint::of(local);
+      for (std::string_view word : tasks[i].words)
+        _insert(local, word.substr(tasks[i].depth), footprints[i]);
+      footprints[i] -= _Footprint::of(local);
+    });
+    for (const _Footprint &footprint : footprints)
+      _footprint += footprint;
+
+    _root->is_dirty = true;
+    _attach_slots(tasks, locals);
+    _rebuild_filter();
+  }
+
+  /**
+   * @brief Moves the child in the slot of each task, if any, under a new
+   * local root, so that work on different slots touches disjoint nodes.
+   * Local roots are not counted in the footprint.
+   */
+  std::vector<std::unique_ptr<Radix_Node>>
+  _detach_slots(const std::vector<_Insert_Task> &tasks) {
+    std::vector<Radix_Node *> parents = _task_parents(tasks);
+    for (const Radix_Node *parent : parents)
+      _footprint -= _Footprint::of(parent);
+
+    std::vector<std::unique_ptr<Radix_Node>> locals;
+    for (const _Insert_Task &task : tasks) {
+      auto &local = locals.emplace_back(std::make_unique<Radix_Node>());
+      auto it = task.parent->children.find(task.key);
+      if (it != task.parent->children.end()) {
+        local->children[task.key] = it->second;
+        task.parent->children.erase(it);
+      }
+    }
+
+    for (const Radix_Node *parent : parents)
+      _footprint += _Footprint::of(parent);
+    return locals;
+  }
+
+  /**
+   * @brief Moves the children of local roots back into the slots of their
+   * tasks, see _detach_slots().
+   */
+  void _attach_slots(const std::vector<_Insert_Task> &tasks,
+                     std::vector<std::unique_ptr<Radix_Node>> &locals) {
+    std::vector<Radix_Node *> parents = _task_parents(tasks);
+    for (const Radix_Node *parent : parents)
+      _footprint -= _Footprint::of(parent);
+
+    for (size_t i = 0; i < tasks.size(); i++) {
+      tasks[i].parent->is_dirty = true;
+      for (auto &entry : locals[i]->children)
+        tasks[i].parent->children[entry.first] = entry.second;
+      locals[i]->children.clear();
+    }
+
+    for (const Radix_Node *parent : parents)
+      _footprint += _Footprint::of(parent);
+  }
+
+  /**
+   * @brief Returns the distinct parents of a list of tasks.
+   */
+  static std::vector<Radix_Node *>
+  _task_parents(const std::vector<_Insert_Task> &tasks) {
+    std::vector<Radix_Node *> parents;
+    for (const _Insert_Task &task : tasks)
+      parents.push_back(task.parent);
+    std::ranges::sort(parents);
+    parents.erase(std::ranges::unique(parents).begin(), parents.end());
+    return parents;
+  }
+
+  /**
+   * @brief Splits insertion tasks that hold more than a given number of
    * words.
    *
+   * The words of a large task share their path up to its slot, and usually
+   * more: the split point is the longest prefix they all share, where they
+   * first branch. The node ending at that prefix is created, splitting a
+   * label if one runs across it, words equal to the prefix are marked there,
+   * and the others become one task per child slot of the node. Tasks are
+   * split again until they are small enough or all their words are equal.
+   *
+   * The node at a split point ends a word or gets at least two children from
+   * its tasks, so the trie is compressed again once they are inserted.
+   *
+   * Large tasks are split one level per round. Within a round their words
+   * are cut into pieces of at most limit words, and the workers find the
+   * shared prefix of each piece, then sort each piece into child slots, so a
+   * task holding nearly all the words is split in parallel too. Only the
+   * split point nodes are created serially.
+   *
+   * Space complexity:  O(w); w is the number of words.
+   * Time complexity:   O(s/t + r*k); s is the total length of the split
+   *                    points of all words, t is the number of threads, r is
+   *                    the number of rounds, k is the number of pieces.
+   *
+   * @param tasks       The tasks to split.
+   * @param limit       Largest number of words a task may keep.
+   * @param n_threads   Number of worker threads.
+   * @return            Tasks no larger than limit, except tasks of equal
+   *                    words.
+   */
+  std::vector<_Insert_Task> _split_insert_tasks(std::vector<_Insert_Task> tasks,
+                                                size_t limit,
+                                                size_t n_threads) {
+    // A slice of the words of a large task, with what the workers found in
+    // it: the prefix length shared with the first word of the task, whether
+    // all its words are as long as that word, whether one ends at the split
+    // point, and the rest of its words by child slot.
+    struct Piece {
+      size_t task;
+      size_t begin;
+      size_t end;
+      size_t shared = 0;
+      bool same_size = true;
+      bool ends_word = false;
+      _Partition children{};
+    };
+
+    std::vector<_Insert_Task> done;
+    while (!tasks.empty()) {
+      std::vector<_Insert_Task> large;
+      for (_Insert_Task &task : tasks)
+        (task.words.size() <= limit ? done : large).push_back(std::move(task));
+      tasks.clear();
+      if (large.empty())
+        break;
+
+      std::vector<Piece> pieces;
+      for (size_t i = 0; i < large.size(); i++)
+        for (size_t begin = 0; begin < large[i].words.size(); begin += limit)
+          pieces.push_back(
+              {i, begin, std::min(begin + limit, large[i].words.size())});
+
+      _parallel_for(pieces.size(), n_threads, [&](size_t i) {
+        Piece &piece = pieces[i];
+        const _Insert_Task &task = large[piece.task];
+        std::string_view first = task.words.front();
+        piece.shared = first.size();
+        for (size_t j = piece.begin; j < piece.end; j++) {
+          std::string_view word = task.words[j];
+          piece.shared =
+              task.depth +
+              mismatch(first.data() + task.depth, word.data() + task.depth,
+                       std::min(piece.shared, word.size()) - task.depth);
+          piece.same_size = piece.same_size && word.size() == first.size();
+        }
+      });
+
+      // Split points, or nullptr for a task of equal words.
+      std::vector<size_t> shared(large.size(), SIZE_MAX);
+      std::vector<bool> equal(large.size(), true);
+      for (const Piece &piece : pieces) {
+        shared[piece.task] = std::min(shared[piece.task], piece.shared);
+        equal[piece.task] = equal[piece.task] && piece.same_size;
+      }
+      std::vector<std::unique_ptr<Radix_Node>> locals = _detach_slots(large);
+      std::vector<Radix_Node *> nodes(large.size());
+      for (size_t i = 0; i < large.size(); i++) {
+        std::string_view first = large[i].words.front();
+        if (equal[i] && shared[i] == first.size())
+          continue;
+        // As in _insert_partitioned(), the local root is left uncounted.
+        Radix_Node *local = locals[i].get();
+        _Footprint footprint = _Footprint::of(local);
+        nodes[i] =
+            _split_point(local, first.substr(0, shared[i]), large[i].depth,
+                         footprint);
+        footprint -= _Footprint::of(local);
+        _footprint += footprint;
+      }
+      _attach_slots(large, locals);
+
+      _parallel_for(pieces.size(), n_threads, [&](size_t i) {
+        Piece &piece = pieces[i];
+        const _Insert_Task &task = large[piece.task];
+        size_t at = shared[piece.task];
+        if (!nodes[piece.task])
+          return;
+        for (size_t j = piece.begin; j < piece.end; j++) {
+          std::string_view word = task.words[j];
+          if (word.size() == at)
+            piece.ends_word = true;
+          else
+            piece.children[static_cast<unsigned char>(word[at])].push_back(
+                word);
+        }
+      });
+
+      // Pieces of a task are consecutive, so one pass gathers each task.
+      for (size_t begin = 0; begin < pieces.size();) {
+        size_t i = pieces[begin].task;
+        size_t end = begin;
+        while (end < pieces.size() && pieces[end].task == i)
+          end++;
+
+        if (!nodes[i]) {
+          done.push_back(std::move(large[i]));
+          begin = end;
+          continue;
+        }
+        for (size_t j = begin; j < end; j++)
+          nodes[i]->is_word = nodes[i]->is_word || pieces[j].ends_word;
+        for (size_t c = 0; c < std::tuple_size_v<_Partition>; c++) {
+          _Insert_Task child{nodes[i], static_cast<char>(c), shared[i], {}};
+          for (size_t j = begin; j < end; j++) {
+            auto &words = pieces[j].children[c];
+            child.words.insert(child.words.end(), words.begin(), words.end());
+          }
+          if (!child.words.empty())
+            tasks.push_back(std::move(child));
+        }
+        begin = end;
+      }
+    }
+    return done;
+  }
+
+  /**
+   * @brief Returns the node that ends exactly at a given path below a
+   * parent, creating it if needed. A label that runs across the end of the
+   * path is split there, and a missing rest of the path becomes one new node
+   * that is not a word. Nodes on the way are marked dirty.
+   *
+   * @param parent      The node to start from.
+   * @param path        The full path of the node to return.
+   * @param depth       Length of the path of parent.
+   * @param footprint   Counters to update for the nodes added or changed.
+   * @return            The node ending at path.
+   */
+  Radix_Node *_split_point(Radix_Node *parent, std::string_view path,
+                           size_t depth, _Footprint &footprint) {
+    Radix_Node *curr = parent;
+    while (depth < path.size()) {
+      curr->is_dirty = true;
+      auto it = curr->children.find(path[depth]);
+      if (it == curr->children.end()) {
+        auto *node = new Radix_Node{std::string(path.substr(depth)), false};
+        footprint -= _Footprint::of(curr);
+        curr->children[path[depth]] = node;
+        footprint += _Footprint::of(curr);
+        footprint += _Footprint::of(node);
+        return node;
+      }
+
+      Radix_Node *child = it->second;
+      size_t match_len =
+          mismatch(child->val.data(), path.data() + depth,
+                   std::min(child->val.size(), path.size() - depth));
+      if (match_len < child->val.size()) {
+        auto *common = new Radix_Node{child->val.substr(0, match_len), false};
+        _rebind(common, curr, child, match_len, footprint);
+        child = common;
+      }
+      curr = child;
+      depth += match_len;
+    }
+
+    curr->is_dirty = true;
+    return curr;
+  }
+
+  /**
+   * @brief Calls a function on every complete line of a buffer.
+   *
+   * @param buf         The buffer to split.
+   * @param last        Whether the buffer ends the input, so that its final
+   *                    unterminated line is complete as well.
+   * @param fn          Callable invoked with each non-empty line, without its
+   *                    line ending.
+   * @return            Number of bytes consumed; the rest is an unterminated
+   *                    line.
+   */
+  template <typename F>
+  static size_t _for_each_line(std::string_view buf, bool last, F &&fn) {
+    size_t pos = 0;
+    while (pos < buf.size()) {
+      const void *nl = std::memchr(buf.data() + pos, '\n', buf.size() - pos);
+      size_t end = nl ? static_cast<size_t>(static_cast<const char *>(nl) -
+                                            buf.data())
+                      : buf.size();
+      if (!nl && !last)
+        break;
+
+      std::string_view line = buf.substr(pos, end - pos);
+      if (line.ends_with('\r'))
+        line.remove_suffix(1);
+      if (!line.empty())
+        fn(line);
+
+      pos = nl ? end + 1 : end;
+    }
+    return pos;
+  }
+
+  /**
+   * @brief Reads a whole newline-delimited stream and inserts its lines on
+   * several worker threads. See load_lines().
+   *
+   * @param is          The stream to read.
+   * @param size        Size of the stream in bytes.
+   * @param n_threads   Number of worker threads.
+   */
+  void _load_lines_parallel(std::istream &is, size_t size, size_t n_threads) {
+    std::string data(size, '\0');
+    is.read(data.data(), static_cast<std::streamsize>(size));
+    data.resize(static_cast<size_t>(is.gcount()));
+    std::string_view buf = data;
+
+    // Slice boundaries are moved past the next newline, so no line is split.
+    std::vector<size_t> bounds{0};
+    for (size_t i = 1; i < n_threads; i++) {
+      size_t pos = std::max(bounds.back(), buf.size() * i / n_threads);
+      size_t nl = buf.find('\n', pos);
+      bounds.push_back(nl == std::string_view::npos ? buf.size() : nl + 1);
+    }
+    bounds.push_back(buf.size());
+
+    std::vector<_Partition> parts(n_threads);
+    _parallel_for(n_threads, n_threads, [&](size_t i) {
+      _for_each_line(buf.substr(bounds[i], bounds[i + 1] - bounds[i]), true,
+                     [&part = parts[i]](std::string_view line) {
+                       part[static_cast<unsigned char>(line[0])].push_back(
+                           line);
+                     });
+    });
+
+    _insert_partitioned(std::move(parts), n_threads);
+  }
+
+  /**
+   * @brief Runs tasks on a pool of worker threads with work stealing.
+   *
+   * Tasks are dealt round-robin into one deque per worker, in index order,
+   * so callers list their largest tasks first. A worker takes tasks from the
+   * front of its own deque and, once it is empty, steals from the back of
+   * the others', where the smallest tasks wait. Each deque has its own lock,
+   * so workers only contend when stealing. The first exception thrown by a
+   * task is rethrown once all workers finish.
+   *
+   * @param n_tasks     Number of tasks, indexed from 0.
+   * @param n_threads   Number of worker threads, at least 1 is used.
+   * @param task        Callable invoked with each task index.
+   */
+  template <typename F>
+  static void _parallel_for(size_t n_tasks, size_t n_threads, F &&task) {
+    struct Queue {
+      std::mutex mtx;
+      std::deque<size_t> tasks;
+    };
+
+    n_threads = std::clamp<size_t>(n_threads, 1, std::max<size_t>(n_tasks, 1));
+    std::vector<Queue> queues(n_threads);
+    for (size_t i = 0; i < n_tasks; i++)
+      queues[i % n_threads].tasks.push_back(i);
+
+    // No task is added once workers start, so a worker that finds every
+    // deque empty is done.
+    auto take = [&queues](size_t self) -> std::optional<size_t> {
+      for (size_t k = 0; k < queues.size(); k++) {
+        Queue &queue = queues[(self + k) % queues.size()];
+        std::lock_guard lock(queue.mtx);
+        if (queue.tasks.empty())
+          continue;
+        size_t i = k == 0 ? queue.tasks.front() : queue.tasks.back();
+        if (k == 0)
+          queue.tasks.pop_front();
+        else
+          queue.tasks.pop_back();
+        return i;
+      }
+      return {};
+    };
+
+    std::exception_ptr error;
+    std::mutex error_mtx;
+    auto worker = [&](size_t self) {
+      while (auto i = take(self)) {
+        try {
+          task(*i);
+        } catch (...) {
+          std::lock_guard lock(error_mtx);
+          if (!error)
+            error = std::current_exception();
+        }
+      }
+    };
+
+    {
+      std::vector<std::jthread> pool;
+      for (size_t i = 1; i < n_threads; i++)
+        pool.emplace_back(worker, i);
+      worker(0);
+    }
+
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+  /**
+   * @brief Inserts a word into the subtree below a given root.
+   *
+   * Space complexity:  O(1).
+   * Time complexity:   O(n), n is the length of the word.
+   *
+   * @param root        The node to insert below.
+   * @param word        The word to insert.
+   * @param footprint   Counters to update for the nodes added or changed.
+   * @return            True if the word was not stored before.
+   */
+  bool _insert(Radix_Node *root, std::string_view word,
+               _Footprint &footprint) {
+    Radix_Node *curr = root;
+    Radix_Node *prev = root;
+    root->is_dirty = true;
+
+    // Nodes on the path below root. The new or split node lands one deeper.
+    size_t depth = 0;
+    size_t w_size = word.size();
+    size_t w_idx = 0;
+    while (w_idx < w_size) {
+
+      char c = word[w_idx];
+      if (!curr->children.contains(c)) {
+        auto *leaf = new Radix_Node{std::string{word.substr(w_idx)}};
+        footprint -= _Footprint::of(curr);
+        curr->children[c] = leaf;
+        footprint += _Footprint::of(curr);
+        footprint += _Footprint::of(leaf);
+        _note_height(depth + 2);
+        return true;
+      }
+
+      prev = curr;
+      curr = curr->children[c];
+      curr->is_dirty = true;
+      depth++;
+      RADIX_TRIE_COUNT(nodes_visited, 1);
+
+      size_t curr_size = curr->val.size();
+      size_t cmp_size = std::min(curr_size, w_size - w_idx);
+      size_t curr_idx =
+          mismatch(curr->val.data(), word.data() + w_idx, cmp_size);
+      w_idx += curr_idx;
+      RADIX_TRIE_COUNT(bytes_compared, curr_idx);
+
+      if (curr_idx < cmp_size) {
+        Radix_Node *common =
+            new Radix_Node{curr->val.substr(0, curr_idx), false};
+        auto *leaf = new Radix_Node{std::string{word.substr(w_idx)}};
+        common->children[word[w_idx]] = leaf;
+        _rebind(common, prev, curr, curr_idx, footprint);
+        footprint += _Footprint::of(leaf);
+        _note_height(depth + 2);
+        return true;
+      }
+
+      if (curr_idx < curr_size && w_idx == w_size) {
+        Radix_Node *common = new Radix_Node{curr->val.substr(0, curr_idx)};
+        _rebind(common, prev, curr, curr_idx, footprint);
+        _note_height(depth + 2);
+        return true;
+      }
+    }
+
+    bool added = !curr->is_word;
+    curr->is_word = true;
+    return added;
+  }
+
+  /**
+   * @brief Adds a word to the filter, if enabled, and rebuilds it with more
+   * room once it holds more words than it was sized for.
+   */
+  void _filter_add(std::string_view word) {
+    if (!_filter)
+      return;
+    _filter->insert(word);
+    if (++_filter_keys > _filter->capacity())
+      _rebuild_filter();
+  }
+
+  /**
+   * @brief Accounts for a removed word, and rebuilds the filter once a
+   * quarter of its words are gone, to restore its false positive rate.
+   */
+  void _filter_note_removal() {
+    if (_filter && ++_filter_removed * 4 > _filter_keys)
+      _rebuild_filter();
+  }
+
+  /**
+   * @brief Rebuilds the filter, if enabled, from the words of the trie,
+   * sized for twice their number.
+   *
+   * Space complexity:  O(w); w is the number of words.
+   * Time complexity:   O(n); n is the number of nodes.
+   */
+  void _rebuild_filter() {
+    if (!_filter)
+      return;
+
+    std::vector<uint64_t> hashes;
+    if (_root->is_word)
+      hashes.push_back(Blocked_Bloom_Filter::hash(""));
+    std::string path;
+    _walk(_root, path, [&](const Radix_Node *node, size_t) {
+      if (node->is_word)
+        hashes.push_back(Blocked_Bloom_Filter::hash(path));
+    });
+
+    auto filter = std::make_unique<Blocked_Bloom_Filter>(
+        std::max(2 * hashes.size(), _filter_min_keys), _filter_bits_per_key);
+    for (uint64_t h : hashes)
+      filter->insert_hash(h);
+    _filter = std::move(filter);
+    _filter_keys = hashes.size();
+    _filter_removed = 0;
+  }
+
+  /**
+   * @brief Raises the height hint to at least a given number of nodes.
+   */
+  void _note_height(size_t height) const {
+    size_t hint = _height_hint.load(std::memory_order_relaxed);
+    while (height > hint && !_height_hint.compare_exchange_weak(
+                                hint, height, std::memory_order_relaxed))
+      ;
+  }
+
+  /**
+   * @brief Visits every node below a start node in depth-first preorder,
+   * with children in the iteration order of their maps.
+   *
+   * The explicit stack holds one frame per level and is reserved from the
+   * height hint, so memory is bounded by the height of the trie and no
+   * recursion is involved.
+   *
+   * Space complexity:  O(h); h is the height of the trie.
+   * Time complexity:   O(n); n is the number of nodes in the subtree.
+   *
+   * @param start       The node whose descendants to visit. It is not
+   *                    visited itself.
+   * @param path        The path up to and including start. Holds the path
+   *                    of each visited node during its visit.
+   * @param visit       Callable invoked with each node and its depth below
+   *                    start, starting at 1.
+   */
+  template <typename F>
+  void _walk(const Radix_Node *start, std::string &path, F &&visit) const {
+    std::vector<_Walk_Frame> stack;
+    stack.reserve(_height_hint.load(std::memory_order_relaxed));
+    stack.push_back({start, start->children.begin(), path.size()});
+
+    while (!stack.empty()) {
+      _Walk_Frame &frame = stack.back();
+      if (frame.next == frame.node->children.end()) {
+        stack.pop_back();
+        continue;
+      }
+
+      const Radix_Node *child = (frame.next++)->second;
+      path.resize(frame.path_size);
+      path += child->val;
+      RADIX_TRIE_COUNT(nodes_visited, 1);
+      visit(child, stack.size());
+
+      if (!child->children.empty()) {
+        stack.push_back({child, child->children.begin(), path.size()});
+        _note_height(stack.size());
+      }
+    }
+  }
+
+  /**
+   * @brief Prints all full words in the trie.
+   *
+   * Space complexity:  O(h); h is the height of the trie.
+   * Time complexity:   O(n); n is the number of nodes.
+   */
+  void _print_list() const {
+    if (_root->is_word)
+      std::cout << '\n';
+
+    std::string path;
+    _walk(_root, path, [&path](const Radix_Node *node, size_t) {
+      if (node->is_word)
+        std::cout << path << '\n';
+    });
+  }
+
+  /**
+   * @brief Prints a visual tree structure of the trie in markdown (MD)
+   * format. Each level adds a '#'.
+   * '𐄂' means that the node forms a word.
+   *
+   * Space complexity:  O(h); h is the height of the trie.
+   * Time complexity:   O(n); n is the number of nodes.
+   */
+  void _print_md() const {
+    auto print = [](const Radix_Node *node, size_t depth) {
+      std::cout << std::format("{} {}{}", std::string(depth + 1, '#'),
+                               node->val, node->is_word ? " 𐄂" : "")
+                << '\n';
+    };
+
+    print(_root, 0);
+    std::string path;
+    _walk(_root, path, print);
+    std::cout.flush();
+  }
+
+  /**
+   * @brief Helper to rebind a node during insertion when a prefix match splits.
+   *
+   * Space complexity:      O(1).
+   * Time complexity:       O(1).
+   *
+   * @param common_node     New intermediate node representing the shared
+   *                        prefix.
+   * @param prev            Parent of the node being split.
+   * @param curr            Node being split and moved under common_node.
+   * @param curr            Index at which to split curr_node's val.
+   */
+  inline void _rebind(Radix_Node *common, Radix_Node *prev, Radix_Node *curr,
+                      size_t curr_idx, _Footprint &footprint) {
+    RADIX_TRIE_COUNT(splits, 1);
+    footprint -= _Footprint::of(prev);
+    footprint -= _Footprint::of(curr);
+    common->children[curr->val[curr_idx]] = curr;
+    prev->children[curr->val[0]] = common;
+    curr->val = curr->val.substr(curr_idx, curr->val.size());
+    footprint += _Footprint::of(prev);
+    footprint += _Footprint::of(curr);
+    footprint += _Footprint::of(common);
+  }
+
+  /**
+   * @brief Removes a word from a Radix Tree.
+   *
+   * Handles both full node deletions (when a node becomes unnecessary) and
+   * logical deletions (by marking the `is_word` flag as false). The method also
+   * compresses nodes when appropriate (i.e., merges a node with its single
+   * child after deletion, if the resulting node no longer represents a word).
+   *
+   * The path is first descended while recording each parent and child key
+   * in a stack reserved from the height hint, and then unwound bottom-up.
+   *
+   * Space complexity:  O(h); h is the height of the trie.
+   * Time complexity:   O(n); n is the length of the word.
+   *
+   * @param word        The word to be removed from the Radix Tree.
+   * @return            True if node was removed or deactivated.
+   */
+  bool _remove(std::string_view word) {
+    std::vector<std::pair<Radix_Node *, char>> path;
+    path.reserve(_height_hint.load(std::memory_order_relaxed));
+
+    Radix_Node *curr = _root;
+    size_t word_idx = 0;
+    while (word_idx < word.length()) {
+      RADIX_TRIE_COUNT(nodes_visited, 1);
+      char c = word[word_idx];
+      auto it = curr->children.find(c);
+      if (it == curr->children.end())
+        return false;
+
+      Radix_Node *child = it->second;
+      RADIX_TRIE_COUNT(bytes_compared, child->val.length());
+      if (word.compare(word_idx, child->val.length(), child->val) != 0)
+        return false;
+
+      path.emplace_back(curr, c);
+      word_idx += child->val.length();
+      curr = child;
+    }
+
+    RADIX_TRIE_COUNT(nodes_visited, 1);
+    if (!curr->is_word)
+      return false;
+    curr->is_word = false;
+    curr->is_dirty = true;
+
+    for (auto level = path.rbegin(); level != path.rend(); ++level) {
+      auto [parent, c] = *level;
+      parent->is_dirty = true;
+
+      auto it = parent->children.find(c);
+      Radix_Node *child = it->second;
+      if (!child->is_word && child->children.empty()) {
+        _footprint -= _Footprint::of(child);
+        _footprint -= _Footprint::of(parent);
+        delete child;
+        parent->children.erase(it);
+        _footprint += _Footprint::of(parent);
+      } else if (!child->is_word && child->children.size() == 1) {
+        RADIX_TRIE_COUNT(merges, 1);
+        auto &grandchild_entry = *child->children.begin();
+        Radix_Node *grandchild = grandchild_entry.second;
+        _footprint -= _Footprint::of(child);
+        _footprint -= _Footprint::of(grandchild);
+        child->val += grandchild->val;
+        child->is_word = grandchild->is_word;
+        child->children = std::move(grandchild->children);
+        delete grandchild;
+        _footprint += _Footprint::of(child);
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * @brief Collects all complete words under the given node.
+   *
+   * The method ensures that only valid, complete words are added to the
+   * completion list, excluding internal path segments that do not terminate
+   * words. Words are collected in the order of _walk().
+   *
    * Space complexity:  O(n); n is the size of the output vector.
    * Time complexity:   O(h); h is the number of nodes in the relevant subtree.
    *
-   * @param curr        Pointer to the current node in the subtree.
+   * @param curr        Pointer to the subtree root.
    * @param out_vec     Reference to a vector where completed words will be
    *                    stored.
    * @param base        A string representing the prefix accumulated along the
-   *                    current path.
+   *                    path to curr.
    */
   void _complete(const Radix_Node *curr, std::vector<std::string> &out_vec,
-                 const std::string &base) const {
-    if (curr->is_word && base != "")
+                 std::string base) const {
+    RADIX_TRIE_COUNT(nodes_visited, 1);
+    if (curr->is_word && !base.empty())
       out_vec.push_back(base);
 
-    if (curr->children.empty())
-      return;
+    _walk(curr, base, [&](const Radix_Node *node, size_t) {
+      if (node->is_word)
+        out_vec.push_back(base);
+    });
+  }
 
-    for (const auto &entry : curr->children) {
-      std::string new_base = base + entry.second->val;
-      _complete(entry.second, out_vec, new_base);
+  /**
+   * @brief Collects all complete words under the given node, as _complete()
+   * does, and also the completions of longer prefixes ending below it.
+   *
+   * The completions of a longer prefix are the ones collected below its
+   * node with the extra prefix characters cut off. Preorder visits a
+   * subtree contiguously, so the range is opened when its node is visited
+   * and closed when the walk comes back up to its depth.
+   *
+   * Space complexity:  O(n); n is the size of the output vectors.
+   * Time complexity:   O(h + n); h is the number of nodes in the relevant
+   *                    subtree.
+   *
+   * @param curr        Pointer to the subtree root.
+   * @param base        The rest of the label of curr below the outer prefix.
+   * @param outer       The prefix that curr completes.
+   * @param nested      Indices of the longer prefixes, by the node each one
+   *                    ends in.
+   * @param prefixes    All prefixes, to look up the longer ones.
+   * @param out_vecs    Output vectors, by prefix index.
+   * @param out_vec     Output vector of the outer prefix.
+   */
+  void _complete_nested(
+      const Radix_Node *curr, std::string base, const std::string &outer,
+      const std::unordered_map<const Radix_Node *, std::vector<size_t>> &nested,
+      const std::vector<std::string> &prefixes,
+      std::vector<std::vector<std::string>> &out_vecs,
+      std::vector<std::string> &out_vec) const {
+    if (nested.empty()) {
+      _complete(curr, out_vec, std::move(base));
+      return;
     }
+
+    struct Range {
+      size_t depth;
+      size_t from;
+      std::vector<size_t> indices;
+    };
+    std::vector<Range> open;
+
+    auto close = [&](size_t depth) {
+      for (; !open.empty() && open.back().depth >= depth; open.pop_back()) {
+        for (size_t i : open.back().indices) {
+          size_t skip = prefixes[i].size() - outer.size();
+          for (size_t j = open.back().from; j < out_vec.size(); j++)
+            if (out_vec[j].size() > skip)
+              out_vecs[i].push_back(out_vec[j].substr(skip));
+        }
+      }
+    };
+
+    // In a frozen trie a node can be reached along several paths, so a
+    // longer prefix only claims its node on the path that spells it.
+    auto visit = [&](const Radix_Node *node, size_t depth) {
+      close(depth);
+      if (auto it = nested.find(node); it != nested.end()) {
+        Range range{depth, out_vec.size(), {}};
+        for (size_t i : it->second)
+          if (std::string_view(base).starts_with(
+                  std::string_view(prefixes[i]).substr(outer.size())))
+            range.indices.push_back(i);
+        if (!range.indices.empty())
+          open.push_back(std::move(range));
+      }
+      if (node->is_word && !base.empty())
+        out_vec.push_back(base);
+    };
+
+    RADIX_TRIE_COUNT(nodes_visited, 1);
+    visit(curr, 0);
+    _walk(curr, base, visit);
+    close(0);
   }
 };
 
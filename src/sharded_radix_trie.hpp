@@ -0,0 +1,259 @@
+/**
+ * @file        sharded_radix_trie.hpp
+ * @brief       Sharded front-end over several radix tries.
+ *
+ * @details     Splits the key space by the leading bytes of each key across
+ *              independent radix tries, each guarded by its own
+ *              reader-writer lock.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#pragma once
+
+#include "radix_trie.hpp"
+
+#include <algorithm>
+#include <concepts>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace radix_trie {
+
+/**
+ * @brief A thread-safe Radix Trie front-end partitioned by key prefix.
+ *
+ * Every key is routed to the shard named by its first `prefix_len` bytes (or
+ * the whole key if it is shorter). Shards are created lazily and kept in key
+ * order. A shard holds only keys starting with its prefix, or the prefix
+ * itself if it is shorter than `prefix_len`, so every key of a shard sorts
+ * before every key of the next one. Merged results are therefore produced
+ * shard by shard, each shard in lexicographic order.
+ *
+ * Each operation locks the shards it touches one at a time. Results that span
+ * several shards are not a snapshot: a writer may change a shard that has not
+ * been read yet. Shards split only on the leading bytes, so keys sharing a
+ * long common prefix land in one shard; a longer `prefix_len` spreads them,
+ * at the cost of more shards to merge.
+ */
+class Sharded_Radix_Trie {
+public:
+  /**
+   * @brief Constructs an empty sharded trie.
+   *
+   * @param prefix_len  Number of leading bytes that select a shard. Must be
+   *                    at least 1. Default is 1.
+   */
+  explicit Sharded_Radix_Trie(size_t prefix_len = 1) : _prefix_len(prefix_len) {
+    if (prefix_len == 0)
+      throw std::invalid_argument(
+          "Invalid shard prefix length 0. It must be at least 1.");
+  }
+
+  /**
+   * @brief Inserts a word into the shard that owns it.
+   *
+   * Space complexity:  O(1).
+   * Time complexity:   O(n + log s); n is the length of the word, s is the
+   *                    number of shards.
+   *
+   * @param word        The word to insert.
+   */
+  void insert(const std::string &word) {
+    Shard &shard = _shard_for(word);
+    std::unique_lock lock(shard.mtx);
+    shard.trie.insert(word);
+  }
+
+  /**
+   * @brief Checks whether a word is stored.
+   *
+   * Space complexity:  O(1).
+   * Time complexity:   O(n + log s); n is the length of the word, s is the
+   *                    number of shards.
+   *
+   * @param word        The word to search for.
+   * @return            True if the word is stored, else false.
+   */
+  bool contains(const std::string &word) const {
+    const Shard *shard = _find_shard(_shard_key(word));
+    if (!shard)
+      return false;
+
+    std::shared_lock lock(shard->mtx);
+    return shard->trie.contains(word);
+  }
+
+  /**
+   * @brief Removes a word from the shard that owns it. Empty shards are kept,
+   * so concurrent writers never race on shard destruction.
+   *
+   * Space complexity:  O(n); n is the length of the word.
+   * Time complexity:   O(n + log s); n is the length of the word, s is the
+   *                    number of shards.
+   *
+   * @param word        The string to be deleted.
+   * @return            True if deletion or deactivation was successful, else
+   *                    false.
+   */
+  bool remove(const std::string &word) {
+    Shard *shard = _find_shard(_shard_key(word));
+    if (!shard)
+      return false;
+
+    std::unique_lock lock(shard->mtx);
+    return shard->trie.remove(word);
+  }
+
+  /**
+   * @brief Finds all completions for a given prefix across all shards, in
+   * lexicographic order. As with Radix_Trie::complete(), completions are
+   * returned without the prefix, and the prefix itself is not one.
+   *
+   * The completions of each shard are sorted before they are appended, and
+   * shards are visited in key order, so the merged result is sorted.
+   *
+   * Space complexity:  O(n); n is the size of the out_vec.
+   * Time complexity:   O(p + h + c*log(c) + s); p is the size of the
+   *                    prefix, h is number of nodes in the relevant subtrees,
+   *                    c is the number of completions, s is the number of
+   *                    shards.
+   *
+   * @param pref        A string that needs to be completed.
+   * @param out_vec     A vector of strings that should be populated with
+   *                    completions.
+   */
+  void complete(const std::string &pref,
+                std::vector<std::string> &out_vec) const {
+    std::shared_lock dir_lock(_dir_mtx);
+
+    if (pref.size() >= _prefix_len) {
+      auto it = _shards.find(pref.substr(0, _prefix_len));
+      if (it == _shards.end())
+        return;
+
+      _complete_sorted(*it->second, pref, out_vec);
+      return;
+    }
+
+    for (auto it = _shards.lower_bound(pref);
+         it != _shards.end() && it->first.starts_with(pref); it++)
+      _complete_sorted(*it->second, pref, out_vec);
+  }
+
+  /**
+   * @brief Calls a function on every word, in lexicographic order across all
+   * shards. Each shard is read-locked while it is visited, so the function
+   * must not modify this trie.
+   *
+   * Space complexity:  O(h*k); h is the height of the tallest shard, k is
+   *                    the largest fanout.
+   * Time complexity:   O(n*log(k) + s); n is the number of nodes, s is the
+   *                    number of shards.
+   *
+   * @param visit       Callable invoked with each word as std::string_view.
+   *                    The view is valid during the call only.
+   */
+  template <typename F>
+    requires std::invocable<F &, std::string_view>
+  void for_each(F &&visit) const {
+    std::shared_lock dir_lock(_dir_mtx);
+    for (const auto &[key, shard] : _shards) {
+      std::shared_lock lock(shard->mtx);
+      shard->trie.for_each(visit);
+    }
+  }
+
+  /**
+   * @brief Returns the number of shards created so far.
+   */
+  size_t shard_count() const {
+    std::shared_lock dir_lock(_dir_mtx);
+    return _shards.size();
+  }
+
+private:
+  /**
+   * @brief A single partition: a trie and the lock guarding it.
+   */
+  struct Shard {
+    Radix_Trie trie;
+    mutable std::shared_mutex mtx;
+  };
+
+  /**
+   * @brief Number of leading bytes that select a shard.
+   */
+  size_t _prefix_len;
+
+  /**
+   * @brief Shards indexed by their key prefix. Shards are never destroyed
+   * before the trie itself, so pointers to them stay valid.
+   */
+  std::map<std::string, std::unique_ptr<Shard>> _shards;
+
+  /**
+   * @brief Guards the shard directory, not the shards themselves.
+   */
+  mutable std::shared_mutex _dir_mtx;
+
+  /**
+   * @brief Returns the shard prefix of a word.
+   */
+  std::string _shard_key(const std::string &word) const {
+    return word.substr(0, _prefix_len);
+  }
+
+  /**
+   * @brief Appends the completions of a prefix in one shard, sorted.
+   */
+  static void _complete_sorted(const Shard &shard, const std::string &pref,
+                               std::vector<std::string> &out_vec) {
+    size_t before = out_vec.size();
+    {
+      std::shared_lock lock(shard.mtx);
+      shard.trie.complete(pref, out_vec);
+    }
+    std::sort(out_vec.begin() + static_cast<ptrdiff_t>(before), out_vec.end());
+  }
+
+  /**
+   * @brief Looks up an existing shard under a shared directory lock.
+   *
+   * @param key         The shard prefix.
+   * @return            Pointer to the shard, or nullptr if it does not exist.
+   */
+  Shard *_find_shard(const std::string &key) const {
+    std::shared_lock dir_lock(_dir_mtx);
+    auto it = _shards.find(key);
+    return it == _shards.end() ? nullptr : it->second.get();
+  }
+
+  /**
+   * @brief Returns the shard owning a word, creating it if needed.
+   *
+   * @param word        The word to route.
+   * @return            Reference to the owning shard.
+   */
+  Shard &_shard_for(const std::string &word) {
+    std::string key = _shard_key(word);
+    if (Shard *shard = _find_shard(key))
+      return *shard;
+
+    std::unique_lock dir_lock(_dir_mtx);
+    auto &slot = _shards[key];
+    if (!slot)
+      slot = std::make_unique<Shard>();
+    return *slot;
+  }
+};
+
+} // namespace radix_trie
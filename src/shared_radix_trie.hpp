@@ -0,0 +1,335 @@
+/**
+ * @file        shared_radix_trie.hpp
+ * @brief       Radix trie published in POSIX shared memory.
+ *
+ * @details     One writer process publishes a trie image into named
+ *              shared-memory segments, and any number of reader processes
+ *              map it and query it in place.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#pragma once
+
+#include "mapped_radix_trie.hpp"
+#include "radix_trie.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <memory>
+#include <new>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace radix_trie {
+
+/**
+ * @brief A read-only Radix Trie shared between processes through POSIX
+ * shared memory.
+ *
+ * A published trie lives in two segments. The control segment, under the
+ * given name, holds magic "RDXS" and an atomic generation counter. The image
+ * segment, under the name suffixed with ".<generation>", holds an image in
+ * the layout of Mapped_Radix_Trie. That layout only uses offsets, so every
+ * process maps it at any address and queries it without copying, and its
+ * pages are shared by all processes of the host.
+ *
+ * A published image is never modified. publish() writes the next
+ * generation into a new image segment, bumps the counter and unlinks the
+ * previous image. Readers keep their mapping, and with it a consistent view,
+ * until they call refresh(). There must be a single writer per name.
+ */
+class Shared_Radix_Trie {
+public:
+  /**
+   * @brief Publishes a trie under a shared-memory name, replacing any
+   * previous version.
+   *
+   * Space complexity:  O(s); s is the size of the image.
+   * Time complexity:   O(n log k); n is the number of nodes, k is the
+   *                    largest fanout.
+   *
+   * @param name        The segment name, starting with '/'.
+   * @param trie        The trie to publish.
+   * @throws            std::system_error if a segment cannot be created.
+   */
+  static void publish(const std::string &name, const Radix_Trie &trie) {
+    std::ostringstream os;
+    Mapped_Radix_Trie::write(trie, os);
+    std::string image = std::move(os).str();
+
+    auto [control, control_size] = _map_segment(name, true);
+    auto *generation = _generation(control);
+    uint64_t next = generation->load(std::memory_order_acquire) + 1;
+
+    std::string image_name = _image_name(name, next);
+    try {
+      int fd = ::shm_open(image_name.c_str(),
+                          O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+      if (fd < 0)
+        _throw_errno("shm_open", image_name);
+
+      void *map = MAP_FAILED;
+      if (::ftruncate(fd, static_cast<off_t>(image.size())) == 0)
+        map = ::mmap(nullptr, image.size(), PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, 0);
+      int err = errno;
+      ::close(fd);
+      if (map == MAP_FAILED) {
+        ::shm_unlink(image_name.c_str());
+        throw std::system_error(err, std::generic_category(),
+                                std::format("map \"{}\"", image_name));
+      }
+      std::memcpy(map, image.data(), image.size());
+      ::munmap(map, image.size());
+    } catch (...) {
+      ::munmap(control, control_size);
+      throw;
+    }
+
+    generation->store(next, std::memory_order_release);
+    ::munmap(control, control_size);
+    if (next > 1)
+      ::shm_unlink(_image_name(name, next - 1).c_str());
+  }
+
+  /**
+   * @brief Removes a published trie. Processes that mapped it keep their
+   * mapping.
+   *
+   * @param name        The segment name.
+   */
+  static void unlink(const std::string &name) {
+    try {
+      auto [control, control_size] = _map_segment(name, false);
+      uint64_t generation =
+          _generation(control)->load(std::memory_order_acquire);
+      ::munmap(control, control_size);
+      ::shm_unlink(_image_name(name, generation).c_str());
+    } catch (const std::exception &) {
+    }
+    ::shm_unlink(name.c_str());
+  }
+
+  /**
+   * @brief Attaches to the latest published version of a trie.
+   *
+   * Space complexity:  O(1).
+   * Time complexity:   O(1).
+   *
+   * @param name        The segment name, starting with '/'.
+   * @throws            std::system_error if a segment cannot be mapped,
+   *                    std::runtime_error if no valid trie is published.
+   */
+  explicit Shared_Radix_Trie(std::string name) : _name(std::move(name)) {
+    std::tie(_control, _control_size) = _map_segment(_name, false);
+    try {
+      _attach_latest();
+    } catch (...) {
+      ::munmap(_control, _control_size);
+      throw;
+    }
+  }
+
+  Shared_Radix_Trie(const Shared_Radix_Trie &) = delete;
+  Shared_Radix_Trie &operator=(const Shared_Radix_Trie &) = delete;
+
+  /**
+   * @brief Unmaps the segments.
+   */
+  ~Shared_Radix_Trie() {
+    _trie.reset();
+    if (_image)
+      ::munmap(_image, _image_size);
+    ::munmap(_control, _control_size);
+  }
+
+  /**
+   * @brief Checks whether a newer version was published since attaching.
+   */
+  bool is_stale() const {
+    return _generation(_control)->load(std::memory_order_acquire) !=
+           _attached;
+  }
+
+  /**
+   * @brief Attaches to the latest published version if this one is stale.
+   *
+   * @return            True if a newer version was attached.
+   * @throws            std::system_error or std::runtime_error if the new
+   *                    version cannot be attached; the old one is kept.
+   */
+  bool refresh() {
+    if (!is_stale())
+      return false;
+    _attach_latest();
+    return true;
+  }
+
+  /**
+   * @brief Returns the generation of the attached version.
+   */
+  uint64_t generation() const { return _attached; }
+
+  /**
+   * @brief Returns the trie for queries. See Mapped_Radix_Trie.
+   */
+  const Mapped_Radix_Trie &trie() const { return *_trie; }
+
+private:
+  static constexpr std::string_view _magic = "RDXS";
+  static constexpr size_t _generation_offset = 8;
+  static constexpr size_t _control_bytes = 16;
+
+  /**
+   * @brief Attempts to open an image before giving up, in case the writer
+   * publishes again between reading the generation and opening its image.
+   */
+  static constexpr int _attach_attempts = 8;
+
+  std::string _name;
+  void *_control = nullptr;
+  size_t _control_size = 0;
+  void *_image = nullptr;
+  size_t _image_size = 0;
+  uint64_t _attached = 0;
+  std::unique_ptr<Mapped_Radix_Trie> _trie;
+
+  [[noreturn]] static void _throw_errno(const char *what,
+                                        const std::string &name) {
+    throw std::system_error(errno, std::generic_category(),
+                            std::format("{} \"{}\"", what, name));
+  }
+
+  static std::string _image_name(const std::string &name, uint64_t gen) {
+    return std::format("{}.{}", name, gen);
+  }
+
+  static std::atomic<uint64_t> *_generation(void *control) {
+    return std::launder(reinterpret_cast<std::atomic<uint64_t> *>(
+        static_cast<char *>(control) + _generation_offset));
+  }
+
+  /**
+   * @brief Maps the control segment of a name. Only the writer maps it
+   * writable; readers open it read-only, so they work under another uid and
+   * cannot change the generation.
+   *
+   * @param name        The segment name.
+   * @param create      Whether to create the segment if it does not exist
+   *                    and map it for writing.
+   * @return            The mapping and its size.
+   */
+  static std::pair<void *, size_t> _map_segment(const std::string &name,
+                                                bool create) {
+    int flags = O_CLOEXEC | (create ? O_RDWR | O_CREAT : O_RDONLY);
+    int fd = ::shm_open(name.c_str(), flags, 0644);
+    if (fd < 0)
+      _throw_errno("shm_open", name);
+
+    struct stat st;
+    bool fresh = false;
+    int rc = ::fstat(fd, &st);
+    if (rc == 0 && st.st_size == 0 && create) {
+      rc = ::ftruncate(fd, _control_bytes);
+      fresh = true;
+    } else if (rc == 0 && static_cast<size_t>(st.st_size) < _control_bytes) {
+      ::close(fd);
+      throw std::runtime_error(
+          std::format("\"{}\" holds no radix trie.", name));
+    }
+
+    void *map = MAP_FAILED;
+    if (rc == 0)
+      map = ::mmap(nullptr, _control_bytes,
+                   create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd,
+                   0);
+    int err = errno;
+    ::close(fd);
+    if (map == MAP_FAILED)
+      throw std::system_error(err, std::generic_category(),
+                              std::format("map \"{}\"", name));
+
+    if (fresh) {
+      std::memcpy(map, _magic.data(), _magic.size());
+      new (static_cast<char *>(map) + _generation_offset)
+          std::atomic<uint64_t>(0);
+    } else if (std::string_view(static_cast<const char *>(map),
+                                _magic.size()) != _magic) {
+      ::munmap(map, _control_bytes);
+      throw std::runtime_error(
+          std::format("\"{}\" holds no radix trie: bad magic.", name));
+    }
+    return {map, _control_bytes};
+  }
+
+  /**
+   * @brief Maps the image of the latest generation, replacing the current
+   * one only once the new one is valid.
+   */
+  void _attach_latest() {
+    for (int attempt = 0; attempt < _attach_attempts; attempt++) {
+      uint64_t gen = _generation(_control)->load(std::memory_order_acquire);
+      if (gen == 0)
+        throw std::runtime_error(
+            std::format("No radix trie is published under \"{}\".", _name));
+
+      std::string image_name = _image_name(_name, gen);
+      int fd = ::shm_open(image_name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+      if (fd < 0 && errno == ENOENT)
+        continue;
+      if (fd < 0)
+        _throw_errno("shm_open", image_name);
+
+      struct stat st;
+      void *map = MAP_FAILED;
+      if (::fstat(fd, &st) == 0 && st.st_size > 0)
+        map = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                     MAP_SHARED, fd, 0);
+      int err = errno;
+      ::close(fd);
+      if (map == MAP_FAILED)
+        throw std::system_error(err, std::generic_category(),
+                                std::format("map \"{}\"", image_name));
+
+      auto size = static_cast<size_t>(st.st_size);
+      std::unique_ptr<Mapped_Radix_Trie> trie;
+      try {
+        trie = std::make_unique<Mapped_Radix_Trie>(std::span<const std::byte>(
+            static_cast<const std::byte *>(map), size));
+      } catch (...) {
+        ::munmap(map, size);
+        throw;
+      }
+
+      _trie = std::move(trie);
+      if (_image)
+        ::munmap(_image, _image_size);
+      _image = map;
+      _image_size = size;
+      _attached = gen;
+      return;
+    }
+
+    throw std::runtime_error(
+        std::format("Radix trie \"{}\" kept changing while attaching.", _name));
+  }
+};
+
+} // namespace radix_trie
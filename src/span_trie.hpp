@@ -0,0 +1,401 @@
+/**
+ * @file        span_trie.hpp
+ * @brief       Radix trie that branches on a configurable number of bits.
+ *
+ * @details     Splits keys into digits of 1, 2, 4 or 8 bits, chosen at
+ *              compile time, and keeps the children of every node in a dense
+ *              array indexed by digit.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#pragma once
+
+#include "instrument.hpp"
+#include "mismatch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace radix_trie {
+
+/**
+ * @brief A path-compressed trie over keys read as digits of Span bits, most
+ * significant first, for binary and hashed keys.
+ *
+ * Inner nodes hold only the index of the digit they branch on and a dense
+ * array of 2^Span children, so each step is a direct index with no search;
+ * the digits skipped between nodes are not stored. Keys live in leaves and a
+ * lookup compares the whole key once it reaches one. A key that ends exactly
+ * where a node branches is held by the node as its terminal.
+ *
+ * Smaller spans make smaller nodes but a taller trie. Digits are read most
+ * significant first, so children in index order visit keys in lexicographic
+ * order and completions come out sorted.
+ *
+ * @tparam Span     Bits per digit: 1, 2, 4 or 8.
+ */
+template <unsigned Span> class Span_Trie {
+  static_assert(Span == 1 || Span == 2 || Span == 4 || Span == 8,
+                "Span must be 1, 2, 4 or 8 bits.");
+
+public:
+  /**
+   * @brief Number of children of an inner node.
+   */
+  static constexpr size_t fanout = size_t{1} << Span;
+
+  /**
+   * @brief Constructs an empty trie.
+   */
+  Span_Trie() = default;
+
+  Span_Trie(const Span_Trie &) = delete;
+  Span_Trie &operator=(const Span_Trie &) = delete;
+
+  /**
+   * @brief Destroys the trie and deallocates all nodes.
+   */
+  ~Span_Trie() {
+    if (!_root)
+      return;
+
+    std::vector<_Node *> stack{_root};
+    while (!stack.empty()) {
+      _Node *curr = stack.back();
+      stack.pop_back();
+      if (!curr->is_leaf) {
+        auto *inner = static_cast<_Inner *>(curr);
+        if (inner->terminal)
+          stack.push_back(inner->terminal);
+        for (_Node *child : inner->children)
+          if (child)
+            stack.push_back(child);
+      }
+      _free(curr);
+    }
+  }
+
+  /**
+   * @brief Inserts a word into the trie.
+   *
+   * A leaf holding any key on the word's path is found first, and the first
+   * digit where the two keys differ tells where the new branch goes.
+   *
+   * Space complexity:  O(n); n is the length of the word.
+   * Time complexity:   O(h*f + n); h is the height of the trie, f is the
+   *                    fanout.
+   *
+   * @param word        The word to insert.
+   * @return            True if the word was added, false if it was stored
+   *                    already.
+   */
+  bool insert(std::string_view word) {
+    RADIX_TRIE_TIME(insert);
+    if (!_root) {
+      _root = _new_leaf(word);
+      _size++;
+      return true;
+    }
+
+    const _Leaf *near = _near_leaf(word);
+    size_t n_digits = _n_digits(word);
+    size_t diff = _first_difference(word, near->key);
+    if (diff == n_digits && diff == _n_digits(near->key))
+      return false;
+
+    _Node **link = &_root;
+    while (!(*link)->is_leaf && static_cast<_Inner *>(*link)->pos < diff) {
+      auto *inner = static_cast<_Inner *>(*link);
+      link = &inner->children[_digit(word, inner->pos)];
+    }
+
+    _Inner *branch;
+    if (!(*link)->is_leaf && static_cast<_Inner *>(*link)->pos == diff) {
+      branch = static_cast<_Inner *>(*link);
+    } else {
+      branch = _new_inner(diff);
+      _slot(branch, near->key) = *link;
+      branch->count = 1;
+      *link = branch;
+    }
+
+    _slot(branch, word) = _new_leaf(word);
+    branch->count++;
+    _size++;
+    return true;
+  }
+
+  /**
+   * @brief Checks whether a word is stored.
+   *
+   * Space complexity:  O(1).
+   * Time complexity:   O(h + n); h is the height of the trie, n is the
+   *                    length of the word.
+   *
+   * @param word        The word to search for.
+   * @return            True if the word is stored, else false.
+   */
+  bool contains(std::string_view word) const {
+    RADIX_TRIE_TIME(find);
+    const _Node *curr = _root;
+    size_t n_digits = _n_digits(word);
+    while (curr && !curr->is_leaf) {
+      RADIX_TRIE_COUNT(nodes_visited, 1);
+      const auto *inner = static_cast<const _Inner *>(curr);
+      if (inner->pos > n_digits)
+        return false;
+      curr = inner->pos == n_digits ? inner->terminal
+                                    : inner->children[_digit(word, inner->pos)];
+    }
+
+    if (!curr)
+      return false;
+    RADIX_TRIE_COUNT(bytes_compared, word.size());
+    return static_cast<const _Leaf *>(curr)->key == word;
+  }
+
+  /**
+   * @brief Removes a word from the trie. An inner node left with a single
+   * entry is replaced by it.
+   *
+   * Space complexity:  O(1).
+   * Time complexity:   O(h*f + n); h is the height of the trie, f is the
+   *                    fanout, n is the length of the word.
+   *
+   * @param word        The word to remove.
+   * @return            True if the word was stored, else false.
+   */
+  bool remove(std::string_view word) {
+    RADIX_TRIE_TIME(remove);
+    _Node **parent_link = nullptr;
+    _Node **link = &_root;
+    size_t n_digits = _n_digits(word);
+    while (*link && !(*link)->is_leaf) {
+      auto *inner = static_cast<_Inner *>(*link);
+      if (inner->pos > n_digits)
+        return false;
+      parent_link = link;
+      link = &_slot(inner, word);
+    }
+
+    if (!*link || static_cast<_Leaf *>(*link)->key != word)
+      return false;
+    _free(*link);
+    *link = nullptr;
+    _size--;
+
+    if (parent_link) {
+      auto *parent = static_cast<_Inner *>(*parent_link);
+      parent->count--;
+      if (parent->count == 1) {
+        RADIX_TRIE_COUNT(merges, 1);
+        *parent_link = _first_entry(parent);
+        _free(parent);
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Finds all completions for a given prefix that form a word, in
+   * lexicographic order. As with Radix_Trie::complete(), completions are
+   * returned without the prefix, and the prefix itself is not one.
+   *
+   * Space complexity:  O(n + h); n is the size of the out_vec, h is the
+   *                    height of the trie.
+   * Time complexity:   O(p + s*f); p is the length of the prefix, s is the
+   *                    number of nodes in the relevant subtree, f is the
+   *                    fanout.
+   *
+   * @param pref        A string that needs to be completed.
+   * @param out_vec     A vector of strings that should be populated with
+   *                    completions.
+   */
+  void complete(std::string_view pref,
+                std::vector<std::string> &out_vec) const {
+    RADIX_TRIE_TIME(complete);
+    const _Node *curr = _root;
+    size_t n_digits = _n_digits(pref);
+    while (curr && !curr->is_leaf &&
+           static_cast<const _Inner *>(curr)->pos < n_digits) {
+      const auto *inner = static_cast<const _Inner *>(curr);
+      curr = inner->children[_digit(pref, inner->pos)];
+    }
+
+    // Every key below shares the digits before the node's, which cover the
+    // prefix, so one key tells whether the whole subtree matches.
+    if (!curr || !_any_leaf(curr)->key.starts_with(pref))
+      return;
+
+    [[maybe_unused]] size_t before = out_vec.size();
+    std::vector<const _Node *> stack{curr};
+    while (!stack.empty()) {
+      const _Node *node = stack.back();
+      stack.pop_back();
+      RADIX_TRIE_COUNT(nodes_visited, 1);
+      if (node->is_leaf) {
+        const std::string &key = static_cast<const _Leaf *>(node)->key;
+        if (key.size() > pref.size())
+          out_vec.push_back(key.substr(pref.size()));
+        continue;
+      }
+
+      const auto *inner = static_cast<const _Inner *>(node);
+      for (size_t i = fanout; i > 0; i--)
+        if (inner->children[i - 1])
+          stack.push_back(inner->children[i - 1]);
+      if (inner->terminal)
+        stack.push_back(inner->terminal);
+    }
+    RADIX_TRIE_RECORD(complete_results, out_vec.size() - before);
+  }
+
+  /**
+   * @brief Returns the number of stored words.
+   */
+  size_t size() const { return _size; }
+
+private:
+  static constexpr size_t _digits_per_byte = 8 / Span;
+  static constexpr unsigned _digit_mask = (1u << Span) - 1;
+
+  struct _Node {
+    bool is_leaf;
+  };
+
+  /**
+   * @brief A leaf: one stored word.
+   */
+  struct _Leaf : _Node {
+    explicit _Leaf(std::string_view key) : _Node{true}, key(key) {}
+
+    std::string key;
+  };
+
+  /**
+   * @brief An inner node. Every key below it shares the digits before pos
+   * and is at least pos digits long; the one that is exactly pos digits
+   * long is the terminal. count is the number of non-null children plus the
+   * terminal, at least 2.
+   */
+  struct _Inner : _Node {
+    explicit _Inner(size_t pos) : _Node{false}, pos(pos) {}
+
+    size_t pos;
+    size_t count = 0;
+    _Node *terminal = nullptr;
+    std::array<_Node *, fanout> children{};
+  };
+
+  _Node *_root = nullptr;
+  size_t _size = 0;
+
+  static size_t _n_digits(std::string_view key) {
+    return key.size() * _digits_per_byte;
+  }
+
+  /**
+   * @brief Returns digit i of a key, which must have more than i digits.
+   */
+  static size_t _digit(std::string_view key, size_t i) {
+    auto byte = static_cast<uint8_t>(key[i / _digits_per_byte]);
+    unsigned shift = 8 - Span * (i % _digits_per_byte + 1);
+    return (byte >> shift) & _digit_mask;
+  }
+
+  /**
+   * @brief Returns the index of the first digit at which two keys differ,
+   * counting the end of the shorter key as a difference.
+   */
+  static size_t _first_difference(std::string_view a, std::string_view b) {
+    size_t len = std::min(a.size(), b.size());
+    size_t byte = mismatch(a.data(), b.data(), len);
+    if (byte == len)
+      return byte * _digits_per_byte;
+
+    auto diff = static_cast<uint8_t>(a[byte] ^ b[byte]);
+    return byte * _digits_per_byte +
+           static_cast<size_t>(std::countl_zero(diff)) / Span;
+  }
+
+  /**
+   * @brief Returns the slot of an inner node that a key below it belongs
+   * in: the terminal if the key ends at the node's digit, else a child.
+   */
+  static _Node *&_slot(_Inner *inner, std::string_view key) {
+    if (_n_digits(key) == inner->pos)
+      return inner->terminal;
+    return inner->children[_digit(key, inner->pos)];
+  }
+
+  /**
+   * @brief Finds a leaf sharing as many leading digits with a word as any
+   * stored key does, by following the word as far as the trie allows.
+   */
+  const _Leaf *_near_leaf(std::string_view word) const {
+    const _Node *curr = _root;
+    size_t n_digits = _n_digits(word);
+    while (!curr->is_leaf) {
+      RADIX_TRIE_COUNT(nodes_visited, 1);
+      const auto *inner = static_cast<const _Inner *>(curr);
+      const _Node *next = inner->pos < n_digits
+                              ? inner->children[_digit(word, inner->pos)]
+                              : inner->terminal;
+      if (!next)
+        return _any_leaf(inner);
+      curr = next;
+    }
+    return static_cast<const _Leaf *>(curr);
+  }
+
+  /**
+   * @brief Returns some leaf below a node, the smallest one.
+   */
+  static const _Leaf *_any_leaf(const _Node *curr) {
+    while (!curr->is_leaf) {
+      const auto *inner = static_cast<const _Inner *>(curr);
+      curr = inner->terminal ? inner->terminal : _first_entry(inner);
+    }
+    return static_cast<const _Leaf *>(curr);
+  }
+
+  /**
+   * @brief Returns the first non-null child of an inner node, or its
+   * terminal if it has no children.
+   */
+  static _Node *_first_entry(const _Inner *inner) {
+    for (_Node *child : inner->children)
+      if (child)
+        return child;
+    return inner->terminal;
+  }
+
+  static _Leaf *_new_leaf(std::string_view word) {
+    RADIX_TRIE_COUNT(allocs, 1);
+    return new _Leaf(word);
+  }
+
+  static _Inner *_new_inner(size_t pos) {
+    RADIX_TRIE_COUNT(allocs, 1);
+    RADIX_TRIE_COUNT(splits, 1);
+    return new _Inner(pos);
+  }
+
+  static void _free(_Node *node) {
+    RADIX_TRIE_COUNT(frees, 1);
+    if (node->is_leaf)
+      delete static_cast<_Leaf *>(node);
+    else
+      delete static_cast<_Inner *>(node);
+  }
+};
+
+} // namespace radix_trie
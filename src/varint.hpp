@@ -0,0 +1,58 @@
+/**
+ * @file        varint.hpp
+ * @brief       Variable-length integer encoding.
+ *
+ * @details     LEB128-style unsigned integers used by the binary trie
+ *              formats: 7 bits per byte, least significant group first, high
+ *              bit set on every byte but the last.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace radix_trie {
+
+/**
+ * @brief Appends a variable-length unsigned integer to a buffer.
+ *
+ * @param out   The buffer to append to.
+ * @param val   The value to encode.
+ */
+inline void put_varint(std::string &out, uint64_t val) {
+  while (val >= 0x80) {
+    out.push_back(static_cast<char>((val & 0x7f) | 0x80));
+    val >>= 7;
+  }
+  out.push_back(static_cast<char>(val));
+}
+
+/**
+ * @brief Reads a variable-length unsigned integer and advances the cursor.
+ *
+ * @param pos   Cursor into the buffer, moved past the integer.
+ * @param end   End of the buffer.
+ * @return      The decoded value.
+ * @throws      std::runtime_error if the integer is truncated or too long.
+ */
+inline uint64_t get_varint(const char *&pos, const char *end) {
+  uint64_t val = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    if (pos == end)
+      throw std::runtime_error("Truncated varint.");
+
+    auto byte = static_cast<unsigned char>(*pos++);
+    val |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+      return val;
+  }
+  throw std::runtime_error("Varint is longer than 64 bits.");
+}
+
+} // namespace radix_trie
@@ -0,0 +1,154 @@
+/**
+ * @file        check.hpp
+ * @brief       Minimal assertion helpers for the test executables.
+ *
+ * @details     CHECK records a failure with its location and keeps going, so
+ *              one run reports every broken expectation. Each test returns
+ *              report() from main, which CTest reads as the verdict. Also
+ *              holds helpers shared by several tests.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#pragma once
+
+#include "radix_trie.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+namespace radix_trie::test {
+
+/**
+ * @brief Number of failed checks so far.
+ */
+inline int failures = 0;
+
+/**
+ * @brief Records a failed check.
+ */
+inline void fail(const char *expr, const char *file, int line) {
+  std::cerr << file << ':' << line << ": check failed: " << expr << '\n';
+  failures++;
+}
+
+/**
+ * @brief Prints the verdict and returns the process exit code.
+ */
+inline int report() {
+  if (failures)
+    std::cerr << failures << " check(s) failed\n";
+  return failures ? 1 : 0;
+}
+
+/**
+ * @brief Checks that two tries have the same nodes: labels, word flags and
+ * child keys, recursively.
+ */
+inline bool same_structure(const Radix_Trie &a, const Radix_Trie &b) {
+  std::vector<std::pair<const Radix_Node *, const Radix_Node *>> stack{
+      {a.root(), b.root()}};
+  while (!stack.empty()) {
+    auto [x, y] = stack.back();
+    stack.pop_back();
+    if (x->val != y->val || x->is_word != y->is_word ||
+        x->children.size() != y->children.size())
+      return false;
+    for (const auto &[c, child] : x->children) {
+      auto it = y->children.find(c);
+      if (it == y->children.end())
+        return false;
+      stack.emplace_back(child, it->second);
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Splits a string into one-byte symbols for random_words().
+ */
+inline std::vector<std::string> bytes_of(std::string_view chars) {
+  std::vector<std::string> symbols;
+  for (char c : chars)
+    symbols.emplace_back(1, c);
+  return symbols;
+}
+
+/**
+ * @brief Seeded random words. Each word is min_length to max_length symbols
+ * drawn from the alphabet, and about half of the words start with the shared
+ * prefix, so that words often are prefixes of others or share long labels.
+ * Symbols may be longer than one byte.
+ */
+inline std::vector<std::string>
+random_words(size_t n, uint32_t seed, const std::vector<std::string> &alphabet,
+             size_t max_length, std::string_view prefix = "",
+             size_t min_length = 0) {
+  std::mt19937 rng(seed);
+  std::vector<std::string> words;
+  words.reserve(n);
+  for (size_t i = 0; i < n; i++) {
+    std::string word(!prefix.empty() && rng() % 2 ? prefix : "");
+    for (size_t j = min_length + rng() % (max_length - min_length + 1); j > 0;
+         j--)
+      word += alphabet[rng() % alphabet.size()];
+    words.push_back(std::move(word));
+  }
+  return words;
+}
+
+/**
+ * @brief A scratch directory, removed with everything in it on destruction.
+ */
+struct Temp_Dir {
+  std::filesystem::path path;
+
+  explicit Temp_Dir(const std::string &name)
+      : path(std::filesystem::temp_directory_path() /
+             (name + '.' + std::to_string(::getpid()))) {
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directories(path);
+  }
+
+  Temp_Dir(const Temp_Dir &) = delete;
+  Temp_Dir &operator=(const Temp_Dir &) = delete;
+
+  ~Temp_Dir() {
+    std::error_code ec;
+    std::filesystem::remove_all(path, ec);
+  }
+
+  std::filesystem::path operator/(const std::string &name) const {
+    return path / name;
+  }
+};
+
+} // namespace radix_trie::test
+
+#define CHECK(expr)                                                            \
+  do {                                                                         \
+    if (!(expr))                                                               \
+      ::radix_trie::test::fail(#expr, __FILE__, __LINE__);                     \
+  } while (false)
+
+#define CHECK_THROWS(expr, type)                                               \
+  do {                                                                         \
+    bool thrown = false;                                                       \
+    try {                                                                      \
+      expr;                                                                    \
+    } catch (const type &) {                                                   \
+      thrown = true;                                                           \
+    }                                                                          \
+    if (!thrown)                                                               \
+      ::radix_trie::test::fail(#expr " throws " #type, __FILE__, __LINE__);    \
+  } while (false)
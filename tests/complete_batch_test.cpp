@@ -0,0 +1,92 @@
+/**
+ * @file        complete_batch_test.cpp
+ * @brief       Tests that batched completions equal one complete() per
+ *              prefix, order included.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#include "check.hpp"
+#include "radix_trie.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace radix_trie;
+
+/**
+ * @brief Checks every batch result against complete() on the same prefix.
+ */
+static void check_batch(const Radix_Trie &trie,
+                        const std::vector<std::string> &prefixes) {
+  std::vector<std::vector<std::string>> out_vecs;
+  trie.complete_batch(prefixes, out_vecs);
+  CHECK(out_vecs.size() == prefixes.size());
+  for (size_t i = 0; i < prefixes.size() && i < out_vecs.size(); i++) {
+    std::vector<std::string> want;
+    trie.complete(prefixes[i], want);
+    CHECK(out_vecs[i] == want);
+  }
+}
+
+static void insert_sample(Radix_Trie &trie) {
+  for (std::string word :
+       {"car", "card", "cards", "care", "careful", "carefully", "cart",
+        "nation", "national", "nations", "station", "stations", "test",
+        "tester", "testing", "te", "a"})
+    trie.insert(word);
+}
+
+static void test_prefix_kinds() {
+  Radix_Trie trie;
+  insert_sample(trie);
+
+  // Duplicates, prefixes nested in each other, prefixes ending inside a
+  // label ("ca", "natio", "carefu"), absent ones and the empty prefix, in
+  // no particular order.
+  check_batch(trie, {"car", "ca", "car", "card", "carefu", "care", "c", "",
+                     "natio", "nation", "nations", "nationsx", "x", "st",
+                     "te", "tes", "testing", "a", "", "zzz", "care"});
+  check_batch(trie, {});
+  check_batch(trie, {""});
+  Radix_Trie empty;
+  check_batch(empty, {"", "a"});
+
+  trie.freeze();
+  check_batch(trie, {"car", "ca", "car", "carefu", "", "natio", "nation",
+                     "station", "s", "te", "test", "tests"});
+}
+
+static void test_random_batches() {
+  std::mt19937 rng(1);
+  Radix_Trie trie;
+  std::vector<std::string> words;
+  for (int i = 0; i < 5000; i++) {
+    std::string word;
+    for (size_t j = 1 + rng() % 10; j > 0; j--)
+      word += "abc"[rng() % 3];
+    trie.insert(word);
+    words.push_back(word);
+  }
+
+  for (int round = 0; round < 2; round++) {
+    for (int batch = 0; batch < 20; batch++) {
+      std::vector<std::string> prefixes;
+      for (size_t i = rng() % 40; i > 0; i--) {
+        const std::string &word = words[rng() % words.size()];
+        prefixes.push_back(word.substr(0, rng() % (word.size() + 2)));
+      }
+      check_batch(trie, prefixes);
+    }
+    trie.freeze();
+  }
+}
+
+int main() {
+  test_prefix_kinds();
+  test_random_batches();
+  return radix_trie::test::report();
+}
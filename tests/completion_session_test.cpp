@@ -0,0 +1,128 @@
+/**
+ * @file        completion_session_test.cpp
+ * @brief       Tests that a completion session answers like a fresh query on
+ *              its prefix after every edit.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#include "check.hpp"
+#include "completion_session.hpp"
+
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace radix_trie;
+
+/**
+ * @brief Checks a session against Radix_Trie::complete() and contains() on
+ * its prefix, and against a set of the stored words.
+ */
+static void check_session(const Completion_Session &session,
+                          const Radix_Trie &trie,
+                          const std::set<std::string> &words,
+                          const std::string &prefix) {
+  CHECK(session.prefix() == prefix);
+  CHECK(session.is_word() == trie.contains(prefix));
+
+  auto it = words.lower_bound(prefix);
+  CHECK(session.matches() == (it != words.end() && it->starts_with(prefix)));
+
+  std::vector<std::string> want;
+  trie.complete(prefix, want);
+  std::vector<std::string> out;
+  session.complete(out);
+  CHECK(out == want);
+}
+
+static void test_random_edits() {
+  std::mt19937 rng(1);
+  Radix_Trie trie;
+  std::set<std::string> words;
+  for (int i = 0; i < 3000; i++) {
+    std::string word;
+    for (size_t j = rng() % 9; j > 0; j--)
+      word += "abc"[rng() % 3];
+    trie.insert(word);
+    words.insert(word);
+  }
+
+  Completion_Session session(trie);
+  std::string prefix;
+  check_session(session, trie, words, prefix);
+  for (int step = 0; step < 5000; step++) {
+    switch (rng() % 8) {
+    case 0:
+    case 1:
+    case 2: {
+      // Mostly letters on stored paths, sometimes one that leaves them.
+      char c = rng() % 6 ? "abc"[rng() % 3] : 'x';
+      session.push(c);
+      prefix += c;
+      break;
+    }
+    case 3: {
+      std::string text(rng() % 4, "abcx"[rng() % 4]);
+      session.push(text);
+      prefix += text;
+      break;
+    }
+    case 4:
+    case 5:
+    case 6: {
+      // Pops of several characters cross from the unmatched tail back into
+      // the matched part.
+      size_t n = std::min<size_t>(rng() % 4, prefix.size());
+      session.pop(n);
+      prefix.resize(prefix.size() - n);
+      break;
+    }
+    default:
+      if (rng() % 4 == 0) {
+        session.reset();
+        prefix.clear();
+      }
+    }
+    check_session(session, trie, words, prefix);
+  }
+}
+
+static void test_unmatched_tail() {
+  Radix_Trie trie;
+  for (std::string word : {"", "car", "card", "care"})
+    trie.insert(word);
+  std::set<std::string> words = {"", "car", "card", "care"};
+
+  Completion_Session session(trie);
+  CHECK(session.is_word());
+  session.push("carx");
+  check_session(session, trie, words, "carx");
+  session.push("yz");
+  check_session(session, trie, words, "carxyz");
+
+  // Deleting the whole tail and one matched character at once.
+  session.pop(4);
+  check_session(session, trie, words, "ca");
+  session.push('r');
+  check_session(session, trie, words, "car");
+  session.pop(3);
+  check_session(session, trie, words, "");
+  CHECK_THROWS(session.pop(), std::out_of_range);
+
+  session.push("cd");
+  session.reset();
+  check_session(session, trie, words, "");
+  session.push("card");
+  check_session(session, trie, words, "card");
+}
+
+int main() {
+  test_random_edits();
+  test_unmatched_tail();
+  return radix_trie::test::report();
+}
@@ -0,0 +1,81 @@
+/**
+ * @file        datasets_test.cpp
+ * @brief       Tests that the benchmark datasets are reproducible from a
+ *              seed.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#include "check.hpp"
+#include "datasets.hpp"
+
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace radix_trie;
+
+static std::string to_hex(const std::string &bytes) {
+  std::string hex;
+  for (unsigned char c : bytes)
+    hex += std::format("{:02x}", c);
+  return hex;
+}
+
+static void test_pinned_keys() {
+  // The first keys of every generator for seed 7. They must not depend on
+  // the compiler or standard library, so they are spelled out here.
+  const std::vector<std::pair<std::string, std::vector<std::string>>> pinned =
+      {
+          {"random", {"axplgmidkcyxww", "wiqtrcilxybkxkzbj"}},
+          {"sequential", {"000000000390", "000000000398"}},
+          {"urls",
+           {"https://www.video415.co.uk/support/store/954085",
+            "https://api.upload16.net/login/public/v1"}},
+          {"file_paths",
+           {"/home/user28/projects/account24/jobs/debug/lib/index_1342.txt",
+            "/home/user29/projects/v26/tools/page/update/feed/products/"
+            "assets_6745.png"}},
+          {"ipv4", {"80.127.23.217", "83.134.76.235"}},
+          {"ipv6",
+           {"2001:641c:956e:5dc2:81d8:2525:aa4a:ae7d",
+            "2001:6d00:50a3:5c70:66f2:2acb:8608:348"}},
+          {"uuids",
+           {"63cbe1e4-5932-4dd7-844c-3cd7f43c661c",
+            "e6984080-bab1-4a02-953a-eb70673e29cb"}},
+          {"zipf_words", {"uning", "caindedisable"}},
+          {"shared_prefix",
+           {"tenant-06/region-eu-central/records/2026/10/partition-0001/"
+            "prnbjyjclqtlfrpabx",
+            "tenant-00/region-eu-central/records/2026/10/partition-0001/"
+            "vdjkzgbgurmadz"}},
+      };
+  for (const auto &[name, keys] : pinned)
+    CHECK(datasets::generate(name, keys.size(), 7) == keys);
+
+  std::vector<std::string> ids = datasets::generate("binary_ids", 2, 7);
+  CHECK(ids.size() == 2);
+  CHECK(to_hex(ids[0]) == "d70d3259e4e1cb631c663cf4d73c4c04");
+  CHECK(to_hex(ids[1]) == "022ab1ba804098e6cb293e6770eb3a95");
+}
+
+static void test_seeds() {
+  for (const datasets::Dataset &dataset : datasets::all) {
+    std::vector<std::string> keys = dataset.generate(1000, 3);
+    CHECK(keys.size() == 1000);
+    CHECK(dataset.generate(1000, 3) == keys);
+    CHECK(dataset.generate(1000, 4) != keys);
+  }
+  CHECK(datasets::generate("urls", 10) == datasets::generate("urls", 10, 0));
+  CHECK_THROWS(datasets::generate("nope", 10), std::invalid_argument);
+}
+
+int main() {
+  test_pinned_keys();
+  test_seeds();
+  return radix_trie::test::report();
+}
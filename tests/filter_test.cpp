@@ -0,0 +1,53 @@
+/**
+ * @file        filter_test.cpp
+ * @brief       Tests of the Bloom filter kept next to the trie.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#include "check.hpp"
+#include "radix_trie.hpp"
+
+#include <string>
+
+using namespace radix_trie;
+
+static void test_reinserts_do_not_grow_filter() {
+  Radix_Trie trie;
+  trie.enable_filter();
+  for (int i = 0; i < 600; i++)
+    trie.insert("word/" + std::to_string(i));
+  size_t bytes = trie.memory_usage().filter;
+
+  // Re-inserting stored words adds nothing, so the filter keeps its size.
+  for (int round = 0; round < 3; round++)
+    for (int i = 0; i < 600; i++)
+      trie.insert("word/" + std::to_string(i));
+  CHECK(trie.memory_usage().filter == bytes);
+
+  for (int i = 0; i < 600; i++)
+    CHECK(trie.contains("word/" + std::to_string(i)));
+  CHECK(!trie.contains("word/600"));
+}
+
+static void test_filter_follows_removals() {
+  Radix_Trie trie;
+  trie.enable_filter();
+  for (int i = 0; i < 5000; i++)
+    trie.insert(std::to_string(i));
+  for (int i = 0; i < 5000; i += 2)
+    trie.remove(std::to_string(i));
+
+  for (int i = 0; i < 5000; i++)
+    CHECK(trie.contains(std::to_string(i)) == (i % 2 == 1));
+  trie.insert("0");
+  CHECK(trie.contains("0"));
+}
+
+int main() {
+  test_reinserts_do_not_grow_filter();
+  test_filter_follows_removals();
+  return radix_trie::test::report();
+}
@@ -0,0 +1,207 @@
+/**
+ * @file        freeze_test.cpp
+ * @brief       Tests of freezing a trie into a DAWG.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#include "check.hpp"
+#include "radix_trie.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace radix_trie;
+using radix_trie::test::same_structure;
+
+/**
+ * @brief Counts the distinct nodes reachable from the root.
+ */
+static size_t distinct_nodes(const Radix_Trie &trie) {
+  std::unordered_set<const Radix_Node *> seen{trie.root()};
+  std::vector<const Radix_Node *> stack{trie.root()};
+  while (!stack.empty()) {
+    const Radix_Node *curr = stack.back();
+    stack.pop_back();
+    for (const auto &entry : curr->children)
+      if (seen.insert(entry.second).second)
+        stack.push_back(entry.second);
+  }
+  return seen.size();
+}
+
+static std::vector<std::string> suffixed_words() {
+  std::vector<std::string> words;
+  for (std::string stem : {"nation", "station", "rel", "cre", "medit", "x"})
+    for (std::string suffix : {"", "s", "al", "ally", "ation", "ations"})
+      words.push_back(stem + suffix);
+  return words;
+}
+
+static void insert_all(Radix_Trie &trie, const std::vector<std::string> &words) {
+  for (const std::string &word : words)
+    trie.insert(word);
+}
+
+static void test_sharing_and_lookups() {
+  std::vector<std::string> words = suffixed_words();
+  Radix_Trie plain;
+  insert_all(plain, words);
+  Radix_Trie frozen;
+  insert_all(frozen, words);
+  frozen.freeze();
+  CHECK(frozen.is_frozen());
+  frozen.freeze();
+
+  // Equal subtrees are one node now, and the shape seen from the root is
+  // unchanged.
+  CHECK(distinct_nodes(frozen) < distinct_nodes(plain));
+  CHECK(same_structure(frozen, plain));
+  const Radix_Node *root = frozen.root();
+  CHECK(root->children.at('n')->children.at('s') ==
+        root->children.at('s')->children.at('s'));
+
+  for (const std::string &word : words)
+    CHECK(frozen.contains(word));
+  for (std::string word : {"", "n", "nations2", "stationa", "creations", "xa"})
+    CHECK(frozen.contains(word) == plain.contains(word));
+  for (std::string pref : {"", "n", "nation", "stationa", "x", "q"}) {
+    std::vector<std::string> want;
+    plain.complete(pref, want);
+    std::vector<std::string> out;
+    frozen.complete(pref, out);
+    std::ranges::sort(want);
+    std::ranges::sort(out);
+    CHECK(out == want);
+  }
+}
+
+static void test_random_words() {
+  std::mt19937 rng(1);
+  std::vector<std::string> words;
+  for (int i = 0; i < 5000; i++) {
+    std::string word;
+    for (size_t j = 1 + rng() % 8; j > 0; j--)
+      word += "ab"[rng() % 2];
+    words.push_back(word);
+  }
+  Radix_Trie plain;
+  insert_all(plain, words);
+  Radix_Trie frozen;
+  insert_all(frozen, words);
+  frozen.freeze();
+  CHECK(same_structure(frozen, plain));
+  CHECK(distinct_nodes(frozen) < distinct_nodes(plain));
+  for (int i = 0; i < 2000; i++) {
+    std::string probe;
+    for (size_t j = rng() % 10; j > 0; j--)
+      probe += "ab"[rng() % 2];
+    CHECK(frozen.contains(probe) == plain.contains(probe));
+  }
+}
+
+static void test_save_load_thaws() {
+  std::vector<std::string> words = suffixed_words();
+  Radix_Trie plain;
+  insert_all(plain, words);
+  Radix_Trie frozen;
+  insert_all(frozen, words);
+  frozen.freeze();
+
+  std::stringstream image;
+  frozen.save(image);
+  Radix_Trie loaded;
+  loaded.load(image);
+  CHECK(!loaded.is_frozen());
+  CHECK(same_structure(loaded, plain));
+  CHECK(distinct_nodes(loaded) == distinct_nodes(plain));
+
+  // The copies of a shared subtree are separate again.
+  loaded.insert("nationsx");
+  CHECK(loaded.contains("nationsx"));
+  CHECK(!loaded.contains("stationsx"));
+
+  // load() into the frozen trie itself replaces and thaws it.
+  std::stringstream again;
+  frozen.save(again);
+  frozen.load(again);
+  CHECK(!frozen.is_frozen());
+  frozen.insert("stationsx");
+  CHECK(frozen.contains("stationsx"));
+  CHECK(!frozen.contains("nationsx"));
+}
+
+static void test_mutation_throws() {
+  radix_trie::test::Temp_Dir dir("freeze_test");
+  Radix_Trie trie;
+  insert_all(trie, suffixed_words());
+  std::stringstream delta;
+  trie.checkpoint_delta(delta);
+  trie.freeze();
+  {
+    std::ofstream os(dir / "words.txt");
+    os << "new\n";
+  }
+
+  std::vector<std::string> more = {"new"};
+  CHECK_THROWS(trie.insert("new"), std::logic_error);
+  CHECK_THROWS(trie.remove("nation"), std::logic_error);
+  CHECK_THROWS(trie.insert_parallel(more, 2), std::logic_error);
+  CHECK_THROWS(trie.load_lines(dir / "words.txt"), std::logic_error);
+  CHECK_THROWS(trie.apply_delta(delta), std::logic_error);
+  CHECK(trie.contains("nation"));
+  CHECK(!trie.contains("new"));
+}
+
+/**
+ * @brief Takes a checkpoint of the base words, applies the mutation, freezes
+ * and checks that the delta turns a replica of the base into the live trie.
+ */
+template <class Mutate>
+static void check_delta_after_freeze(const std::vector<std::string> &base,
+                                     Mutate mutate) {
+  Radix_Trie trie;
+  insert_all(trie, base);
+  std::stringstream snapshot;
+  trie.checkpoint(snapshot);
+  Radix_Trie replica;
+  replica.load(snapshot);
+
+  mutate(trie);
+  trie.freeze();
+  std::stringstream delta;
+  trie.checkpoint_delta(delta);
+  replica.apply_delta(delta);
+  CHECK(same_structure(replica, trie));
+}
+
+static void test_delta_after_freeze() {
+  // A dirty subtree must not be replaced by an equal clean one taken from
+  // another path, or the delta would point at the wrong base subtree.
+  check_delta_after_freeze({"nat", "nation", "nations", "cation", "cat"},
+                           [](Radix_Trie &trie) { trie.remove("nations"); });
+  check_delta_after_freeze({"nat", "cation", "cat"},
+                           [](Radix_Trie &trie) { trie.insert("nation"); });
+  check_delta_after_freeze(suffixed_words(), [](Radix_Trie &trie) {
+    trie.insert("relations");
+    trie.remove("stationally");
+    trie.insert("xy");
+  });
+}
+
+int main() {
+  test_sharing_and_lookups();
+  test_random_words();
+  test_save_load_thaws();
+  test_mutation_throws();
+  test_delta_after_freeze();
+  return radix_trie::test::report();
+}
@@ -0,0 +1,102 @@
+/**
+ * @file        front_coded_trie_test.cpp
+ * @brief       Tests of the front-coded export format and its reader.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#include "check.hpp"
+#include "front_coded_trie.hpp"
+
+#include <set>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace radix_trie;
+
+static std::set<std::string> random_words(size_t n, uint32_t seed) {
+  std::vector<std::string> words =
+      test::random_words(n, seed, test::bytes_of("ab\x80\xff"), 9, "common/");
+  return {words.begin(), words.end()};
+}
+
+/**
+ * @brief Checks that a compressed set answers like a set of words.
+ */
+static void check_matches(const Front_Coded_Trie &fc,
+                          const std::set<std::string> &words) {
+  CHECK(fc.size() == words.size());
+  for (const std::string &word : words)
+    CHECK(fc.contains(word));
+  for (const std::string &probe : random_words(300, 7))
+    CHECK(fc.contains(probe) == words.contains(probe));
+
+  for (std::string pref : {"", "a", "common/", "common/a\x80", "\xff", "zz"}) {
+    std::vector<std::string> want;
+    for (auto it = words.lower_bound(pref);
+         it != words.end() && it->starts_with(pref); it++)
+      if (it->size() > pref.size())
+        want.push_back(it->substr(pref.size()));
+
+    std::vector<std::string> out;
+    fc.complete(pref, out);
+    CHECK(out == want);
+  }
+}
+
+static void test_round_trip() {
+  radix_trie::test::Temp_Dir dir("front_coded_trie_test");
+  std::set<std::string> words = random_words(3000, 1);
+  Radix_Trie trie;
+  for (const std::string &word : words)
+    trie.insert(word);
+
+  for (size_t block_size : {1, 2, 16}) {
+    Front_Coded_Trie::write(trie, dir / "words.fc", block_size);
+    Front_Coded_Trie mapped(dir / "words.fc");
+    check_matches(mapped, words);
+
+    std::ostringstream os;
+    Front_Coded_Trie::write(trie, os, block_size);
+    std::string image = os.str();
+    Front_Coded_Trie wrapped(std::as_bytes(std::span(image)));
+    check_matches(wrapped, words);
+
+    Front_Coded_Trie moved(std::move(mapped));
+    check_matches(moved, words);
+  }
+}
+
+static void test_empty_and_corrupt() {
+  radix_trie::test::Temp_Dir dir("front_coded_trie_test");
+  Front_Coded_Trie::write(Radix_Trie(), dir / "empty.fc");
+  Front_Coded_Trie empty(dir / "empty.fc");
+  CHECK(empty.size() == 0);
+  CHECK(!empty.contains(""));
+  std::vector<std::string> out;
+  empty.complete("", out);
+  CHECK(out.empty());
+
+  std::string junk = "RDXM";
+  CHECK_THROWS(Front_Coded_Trie(std::as_bytes(std::span(junk))),
+               std::runtime_error);
+  std::ostringstream os;
+  Radix_Trie trie;
+  trie.insert("word");
+  Front_Coded_Trie::write(trie, os);
+  std::string bad_offset = os.str();
+  bad_offset[bad_offset.size() - 1] = '\x7f';
+  CHECK_THROWS(Front_Coded_Trie(std::as_bytes(std::span(bad_offset))),
+               std::runtime_error);
+  CHECK_THROWS(Front_Coded_Trie(dir / "missing.fc"), std::system_error);
+}
+
+int main() {
+  test_round_trip();
+  test_empty_and_corrupt();
+  return radix_trie::test::report();
+}
@@ -0,0 +1,77 @@
+/**
+ * @file        instrument_test.cpp
+ * @brief       Tests that every completion entry point feeds the completion
+ *              histograms.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#define RADIX_TRIE_INSTRUMENT
+
+#include "check.hpp"
+#include "completion_session.hpp"
+#include "radix_trie.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace radix_trie;
+
+/**
+ * @brief Checks that a call adds one completion with the given number of
+ * results.
+ */
+template <typename F>
+static void check_records(F &&call, uint64_t results) {
+  instrument::latencies.reset();
+  call();
+  CHECK(instrument::latencies.complete.count() == 1);
+  CHECK(instrument::latencies.complete_results.count() == 1);
+  CHECK(instrument::latencies.complete_results.max() == results);
+}
+
+static void test_completion_entry_points() {
+  Radix_Trie trie;
+  for (int i = 0; i < 100; i++)
+    trie.insert("key/" + std::to_string(i));
+
+  check_records(
+      [&] {
+        std::vector<std::string> out;
+        trie.complete("key/1", out);
+      },
+      10);
+  check_records(
+      [&] {
+        std::vector<std::string> out;
+        trie.complete_parallel("key/", out, 4);
+      },
+      100);
+  check_records(
+      [&] {
+        trie.complete_parallel(
+            "key/", [](std::vector<std::string> &&) {}, 4);
+      },
+      100);
+  check_records(
+      [&] {
+        std::vector<std::vector<std::string>> out_vecs;
+        trie.complete_batch({"key/1", "key/2", "none"}, out_vecs);
+      },
+      20);
+  check_records(
+      [&] {
+        Completion_Session session(trie);
+        session.push("key/9");
+        std::vector<std::string> out;
+        session.complete(out);
+      },
+      10);
+}
+
+int main() {
+  test_completion_entry_points();
+  return radix_trie::test::report();
+}
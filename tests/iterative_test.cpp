@@ -0,0 +1,189 @@
+/**
+ * @file        iterative_test.cpp
+ * @brief       Tests of the non-recursive traversals: remove, complete,
+ *              print and node destruction.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#include "check.hpp"
+#include "radix_trie.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+
+using namespace radix_trie;
+using radix_trie::test::bytes_of;
+using radix_trie::test::random_words;
+
+/**
+ * @brief Runs a callable on a thread with a given stack size, so that deep
+ * recursion would overflow it.
+ */
+template <typename F> static void run_with_stack(size_t stack_size, F f) {
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setstacksize(&attr, stack_size);
+  pthread_t thread;
+  auto entry = [](void *arg) -> void * {
+    (*static_cast<F *>(arg))();
+    return nullptr;
+  };
+  CHECK(pthread_create(&thread, &attr, entry, &f) == 0);
+  pthread_join(thread, nullptr);
+  pthread_attr_destroy(&attr);
+}
+
+/**
+ * @brief Stream buffer that only counts what is written to it.
+ */
+struct Counting_Buf : std::streambuf {
+  size_t bytes = 0;
+  size_t lines = 0;
+
+  int_type overflow(int_type c) override {
+    if (c != traits_type::eof()) {
+      bytes++;
+      lines += c == '\n';
+    }
+    return c;
+  }
+
+  std::streamsize xsputn(const char *s, std::streamsize n) override {
+    bytes += static_cast<size_t>(n);
+    lines += static_cast<size_t>(std::count(s, s + n, '\n'));
+    return n;
+  }
+};
+
+/**
+ * @brief Sends std::cout to another buffer while in scope.
+ */
+struct Redirect_Cout {
+  std::streambuf *saved;
+
+  explicit Redirect_Cout(std::streambuf *buf) : saved(std::cout.rdbuf(buf)) {}
+  ~Redirect_Cout() { std::cout.rdbuf(saved); }
+};
+
+/**
+ * @brief Words in depth-first preorder with children in map iteration
+ * order, collected recursively as the traversals did before.
+ */
+static void preorder_words(const Radix_Node *node, std::string &path,
+                           std::vector<std::string> &out) {
+  size_t size = path.size();
+  path += node->val;
+  if (node->is_word)
+    out.push_back(path);
+  for (const auto &entry : node->children)
+    preorder_words(entry.second, path, out);
+  path.resize(size);
+}
+
+static void test_deep_chain() {
+  // Every prefix of a long run of 'a' is a word, so each node has one child
+  // and the trie is as deep as the longest word.
+  constexpr size_t depth = 3000;
+  run_with_stack(64 * 1024, [] {
+    Radix_Trie trie;
+    for (size_t k = 1; k <= depth; k++)
+      trie.insert(std::string(k, 'a'));
+
+    std::vector<std::string> out;
+    trie.complete("", out);
+    CHECK(out.size() == depth);
+    bool in_order = out.size() == depth;
+    for (size_t i = 0; in_order && i < depth; i++)
+      in_order = out[i].size() == i + 1;
+    CHECK(in_order);
+    out.clear();
+    trie.complete(std::string(depth - 1, 'a'), out);
+    CHECK(out == std::vector<std::string>{"a"});
+
+    Counting_Buf list;
+    {
+      Redirect_Cout redirect(&list);
+      trie.print("list");
+    }
+    CHECK(list.lines == depth);
+    CHECK(list.bytes == depth * (depth + 1) / 2 + depth);
+    Counting_Buf md;
+    {
+      Redirect_Cout redirect(&md);
+      trie.print("md");
+    }
+    CHECK(md.lines == depth + 1);
+
+    // Removing the odd lengths from the top leaves a word-less node with one
+    // child at every level, which is merged into it.
+    for (size_t k = 1; k <= depth; k += 2)
+      CHECK(trie.remove(std::string(k, 'a')));
+    const Radix_Node *top = trie.root()->children.at('a');
+    CHECK(top->val == "aa");
+    CHECK(top->children.at('a')->val == "aa");
+    out.clear();
+    trie.complete("", out);
+    CHECK(out.size() == depth / 2);
+    for (size_t k = 1; k <= depth; k += 299)
+      CHECK(trie.contains(std::string(k, 'a')) == (k % 2 == 0));
+
+    // The even lengths from the bottom free one leaf at a time.
+    for (size_t k = depth; k >= 2; k -= 2)
+      CHECK(trie.remove(std::string(k, 'a')));
+    CHECK(trie.root()->children.empty());
+    CHECK(!trie.remove("a"));
+
+    // Destroyed while still deep.
+    Radix_Trie doomed;
+    for (size_t k = 1; k <= depth; k++)
+      doomed.insert(std::string(k, 'a'));
+    CHECK(doomed.contains(std::string(depth, 'a')));
+  });
+}
+
+static void test_order_matches_recursion() {
+  Radix_Trie trie;
+  for (const std::string &word :
+       random_words(5000, 1, bytes_of("abc/\xff"), 8, "shared/"))
+    trie.insert(word);
+
+  std::vector<std::string> want;
+  std::string path;
+  preorder_words(trie.root(), path, want);
+
+  for (std::string pref : {"", "a", "ab", "shared/", "shared/a", "shared/ab",
+                           "\xff", "q"}) {
+    std::vector<std::string> expected;
+    for (const std::string &word : want)
+      if (word.size() > pref.size() && word.starts_with(pref))
+        expected.push_back(word.substr(pref.size()));
+    std::vector<std::string> out;
+    trie.complete(pref, out);
+    CHECK(out == expected);
+  }
+
+  std::string expected;
+  for (const std::string &word : want)
+    expected += word + '\n';
+  std::ostringstream list;
+  {
+    Redirect_Cout redirect(list.rdbuf());
+    trie.print("list");
+  }
+  CHECK(list.str() == expected);
+}
+
+int main() {
+  test_deep_chain();
+  test_order_matches_recursion();
+  return radix_trie::test::report();
+}
@@ -0,0 +1,254 @@
+/**
+ * @file        logged_radix_trie_test.cpp
+ * @brief       Tests of write-ahead log replay, torn tails and checkpoints.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#include "check.hpp"
+#include "logged_radix_trie.hpp"
+#include "varint.hpp"
+
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace radix_trie;
+using radix_trie::test::same_structure;
+using namespace std::chrono_literals;
+
+static constexpr size_t wal_header_size = 5;
+
+static void append_bytes(const std::filesystem::path &path,
+                         const std::string &bytes) {
+  std::ofstream os(path, std::ios::binary | std::ios::app);
+  os.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+static void test_replay_after_reopen() {
+  radix_trie::test::Temp_Dir dir("logged_radix_trie_test");
+  Radix_Trie expected;
+  {
+    Logged_Radix_Trie trie(dir / "snap", dir / "wal");
+    for (int i = 0; i < 1000; i++) {
+      trie.insert(std::to_string(i));
+      expected.insert(std::to_string(i));
+    }
+    for (int i = 0; i < 1000; i += 3) {
+      CHECK(trie.remove(std::to_string(i)));
+      expected.remove(std::to_string(i));
+    }
+    CHECK(!trie.remove("absent"));
+  }
+
+  Logged_Radix_Trie reopened(dir / "snap", dir / "wal");
+  CHECK(same_structure(reopened.trie(), expected));
+  CHECK(!std::filesystem::exists(dir / "snap"));
+}
+
+static void test_remove_checks_whole_label() {
+  // "axc" shares only the first byte with the label "abc", which remove()
+  // once took as a match.
+  Radix_Trie plain;
+  plain.insert("abc");
+  CHECK(!plain.remove("axc"));
+  CHECK(!plain.remove("ab"));
+  CHECK(!plain.remove("abcd"));
+  CHECK(plain.contains("abc"));
+
+  radix_trie::test::Temp_Dir dir("logged_radix_trie_test");
+  {
+    Logged_Radix_Trie trie(dir / "snap", dir / "wal");
+    trie.insert("abc");
+    trie.insert("abd");
+    CHECK(!trie.remove("axc"));
+    CHECK(!trie.remove("abx"));
+    CHECK(trie.trie().contains("abc"));
+    CHECK(trie.trie().contains("abd"));
+  }
+  Logged_Radix_Trie reopened(dir / "snap", dir / "wal");
+  CHECK(reopened.trie().contains("abc"));
+  CHECK(reopened.trie().contains("abd"));
+}
+
+static void test_torn_tail() {
+  radix_trie::test::Temp_Dir dir("logged_radix_trie_test");
+  {
+    Logged_Radix_Trie trie(dir / "snap", dir / "wal");
+    trie.insert("alpha");
+    trie.insert("beta");
+    trie.remove("alpha");
+  }
+  auto valid_size = std::filesystem::file_size(dir / "wal");
+
+  // A record cut inside its word.
+  std::string torn = "i";
+  put_varint(torn, 10);
+  torn += "gam";
+  append_bytes(dir / "wal", torn);
+  {
+    Logged_Radix_Trie trie(dir / "snap", dir / "wal");
+    CHECK(trie.trie().contains("beta"));
+    CHECK(!trie.trie().contains("alpha"));
+    CHECK(std::filesystem::file_size(dir / "wal") == valid_size);
+    trie.insert("delta");
+  }
+
+  // A whole record with a bad checksum, then a length near 2^64 that must
+  // not wrap around the bounds check.
+  valid_size = std::filesystem::file_size(dir / "wal");
+  std::string bad = "i";
+  put_varint(bad, 5);
+  bad += "gamma";
+  bad += std::string(4, '\0');
+  std::string huge = "i";
+  put_varint(huge, std::numeric_limits<uint64_t>::max() - 2);
+  huge += "xxxxxxxx";
+  append_bytes(dir / "wal", bad + huge);
+  {
+    Logged_Radix_Trie trie(dir / "snap", dir / "wal");
+    CHECK(trie.trie().contains("beta"));
+    CHECK(trie.trie().contains("delta"));
+    CHECK(!trie.trie().contains("gamma"));
+    CHECK(std::filesystem::file_size(dir / "wal") == valid_size);
+  }
+
+  append_bytes(dir / "wal", huge);
+  {
+    Logged_Radix_Trie trie(dir / "snap", dir / "wal");
+    CHECK(trie.trie().contains("delta"));
+    CHECK(std::filesystem::file_size(dir / "wal") == valid_size);
+  }
+}
+
+static void test_crash_loses_only_uncommitted() {
+  radix_trie::test::Temp_Dir dir("logged_radix_trie_test");
+  pid_t pid = ::fork();
+  if (pid == 0) {
+    Logged_Radix_Trie trie(dir / "snap", dir / "wal", 1 << 20, true, 1h);
+    trie.insert("kept");
+    trie.commit();
+    trie.insert("lost");
+    // Exit without destructors, as a crash would.
+    ::_exit(0);
+  }
+  int status = 0;
+  CHECK(::waitpid(pid, &status, 0) == pid);
+  CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+  Logged_Radix_Trie trie(dir / "snap", dir / "wal");
+  CHECK(trie.trie().contains("kept"));
+  CHECK(!trie.trie().contains("lost"));
+}
+
+static void test_short_write_is_continued() {
+  radix_trie::test::Temp_Dir dir("logged_radix_trie_test");
+  const std::string long_word(100, 'x');
+  pid_t pid = ::fork();
+  if (pid == 0) {
+    // A file size limit makes the write stop 10 bytes into the record and
+    // the next write fail with EFBIG, as a full disk would.
+    std::signal(SIGXFSZ, SIG_IGN);
+    int code = 0;
+    {
+      Logged_Radix_Trie trie(dir / "snap", dir / "wal", 1 << 20, false, 1h);
+      trie.insert("before");
+      trie.commit();
+      auto size = std::filesystem::file_size(dir / "wal");
+
+      rlimit limit;
+      ::getrlimit(RLIMIT_FSIZE, &limit);
+      rlimit small = limit;
+      small.rlim_cur = size + 10;
+      ::setrlimit(RLIMIT_FSIZE, &small);
+      trie.insert(long_word);
+      try {
+        trie.commit();
+        code = 1;
+      } catch (const std::system_error &) {
+      }
+      if (std::filesystem::file_size(dir / "wal") != size + 10)
+        code = 2;
+
+      ::setrlimit(RLIMIT_FSIZE, &limit);
+      trie.insert("after");
+      trie.commit();
+    }
+    ::_exit(code);
+  }
+  int status = 0;
+  CHECK(::waitpid(pid, &status, 0) == pid);
+  CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+  Logged_Radix_Trie trie(dir / "snap", dir / "wal");
+  CHECK(trie.trie().contains("before"));
+  CHECK(trie.trie().contains(long_word));
+  CHECK(trie.trie().contains("after"));
+}
+
+static void test_group_triggers() {
+  radix_trie::test::Temp_Dir dir("logged_radix_trie_test");
+  {
+    Logged_Radix_Trie trie(dir / "snap", dir / "wal", 1 << 20, false, 1h);
+    trie.insert("a");
+    trie.insert("b");
+    CHECK(std::filesystem::file_size(dir / "wal") == wal_header_size);
+    trie.commit();
+    CHECK(std::filesystem::file_size(dir / "wal") > wal_header_size);
+  }
+  {
+    Logged_Radix_Trie trie(dir / "snap2", dir / "wal2", 1 << 20, false, 0us);
+    trie.insert("a");
+    CHECK(std::filesystem::file_size(dir / "wal2") > wal_header_size);
+  }
+  {
+    Logged_Radix_Trie trie(dir / "snap3", dir / "wal3", 16, false, 1h);
+    trie.insert("abcdefghijklmnop");
+    CHECK(std::filesystem::file_size(dir / "wal3") > wal_header_size);
+  }
+}
+
+static void test_checkpoint() {
+  radix_trie::test::Temp_Dir dir("logged_radix_trie_test");
+  Radix_Trie expected;
+  {
+    Logged_Radix_Trie trie(dir / "snap", dir / "wal");
+    for (int i = 0; i < 500; i++) {
+      trie.insert("before/" + std::to_string(i));
+      expected.insert("before/" + std::to_string(i));
+    }
+    trie.checkpoint();
+    CHECK(std::filesystem::file_size(dir / "wal") == wal_header_size);
+    CHECK(!std::filesystem::exists(dir / "snap.tmp"));
+
+    for (int i = 0; i < 100; i++) {
+      trie.insert("after/" + std::to_string(i));
+      expected.insert("after/" + std::to_string(i));
+      trie.remove("before/" + std::to_string(i));
+      expected.remove("before/" + std::to_string(i));
+    }
+  }
+
+  Logged_Radix_Trie reopened(dir / "snap", dir / "wal");
+  CHECK(same_structure(reopened.trie(), expected));
+}
+
+int main() {
+  test_replay_after_reopen();
+  test_remove_checks_whole_label();
+  test_torn_tail();
+  test_crash_loses_only_uncommitted();
+  test_short_write_is_continued();
+  test_group_triggers();
+  test_checkpoint();
+  return radix_trie::test::report();
+}
@@ -0,0 +1,103 @@
+/**
+ * @file        mapped_radix_trie_test.cpp
+ * @brief       Tests of the memory-mapped trie image.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#include "check.hpp"
+#include "mapped_radix_trie.hpp"
+
+#include <algorithm>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace radix_trie;
+
+static std::string image_of(const Radix_Trie &trie) {
+  std::ostringstream os;
+  Mapped_Radix_Trie::write(trie, os);
+  return os.str();
+}
+
+static std::span<const std::byte> bytes(const std::string &image) {
+  return {reinterpret_cast<const std::byte *>(image.data()), image.size()};
+}
+
+static uint32_t get_u32(const std::string &image, size_t pos) {
+  uint32_t val = 0;
+  for (int i = 3; i >= 0; i--)
+    val = (val << 8) | static_cast<unsigned char>(image[pos + i]);
+  return val;
+}
+
+static void set_u32(std::string &image, size_t pos, uint32_t val) {
+  for (int i = 0; i < 4; i++)
+    image[pos + i] = static_cast<char>(val >> (8 * i));
+}
+
+static void test_queries_match_trie() {
+  Radix_Trie trie;
+  for (std::string word : {"", "a", "ab", "abc", "abd", "b", "\xff", "ba"})
+    trie.insert(word);
+
+  radix_trie::test::Temp_Dir dir("mapped_radix_trie_test");
+  Mapped_Radix_Trie::write(trie, dir / "trie.img");
+  Mapped_Radix_Trie mapped(dir / "trie.img");
+
+  for (std::string word : {"", "a", "ab", "abc", "abd", "b", "\xff", "ba"})
+    CHECK(mapped.contains(word));
+  for (std::string word : {"abcd", "c", "\xfe", "bb"})
+    CHECK(!mapped.contains(word));
+  CHECK(mapped.longest_prefix("abce") == 3);
+  CHECK(mapped.longest_prefix("c") == 0);
+
+  for (std::string pref : {"", "a", "b", "ab"}) {
+    std::vector<std::string> expected;
+    trie.complete(pref, expected);
+    std::ranges::sort(expected);
+    std::vector<std::string> out;
+    mapped.complete(pref, out);
+    CHECK(out == expected);
+  }
+}
+
+static void test_rejects_backward_children() {
+  // Root "" with child "a", which has child "b".
+  Radix_Trie trie;
+  trie.insert("a");
+  trie.insert("ab");
+  const std::string image = image_of(trie);
+  const size_t root = 4 * size_t{get_u32(image, 8)};
+  const uint32_t a = get_u32(image, root + 8);
+
+  // The root's child slot points back at the root.
+  std::string to_root = image;
+  set_u32(to_root, root + 8, get_u32(image, 8));
+  Mapped_Radix_Trie loop(bytes(to_root));
+  CHECK_THROWS(loop.contains("aaaa"), std::runtime_error);
+  std::vector<std::string> out;
+  CHECK_THROWS(loop.complete("", out), std::runtime_error);
+
+  // The child slot of "a" points at "a" itself.
+  std::string to_self = image;
+  set_u32(to_self, 4 * size_t{a} + 8, a);
+  Mapped_Radix_Trie self(bytes(to_self));
+  CHECK_THROWS(self.contains("abbb"), std::runtime_error);
+  CHECK_THROWS(self.longest_prefix("abbb"), std::runtime_error);
+  CHECK_THROWS(self.complete("a", out), std::runtime_error);
+
+  std::string bad_root = image;
+  set_u32(bad_root, 8, static_cast<uint32_t>(image.size()));
+  CHECK_THROWS(Mapped_Radix_Trie(bytes(bad_root)), std::runtime_error);
+}
+
+int main() {
+  test_queries_match_trie();
+  test_rejects_backward_children();
+  return radix_trie::test::report();
+}
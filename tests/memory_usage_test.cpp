@@ -0,0 +1,152 @@
+/**
+ * @file        memory_usage_test.cpp
+ * @brief       Tests that the running memory counters match a full walk.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#include "check.hpp"
+#include "radix_trie.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace radix_trie;
+
+/**
+ * @brief Measures a trie by visiting every node, with the same estimates as
+ * Radix_Trie::memory_usage(), without the filter.
+ */
+static Memory_Usage walk_usage(const Radix_Trie &trie) {
+  const size_t sso_capacity = std::string().capacity();
+  const size_t entry_size =
+      sizeof(void *) + sizeof(std::pair<const char, Radix_Node *>);
+  Memory_Usage usage;
+  auto add = [&usage](size_t &field, size_t size) {
+    field += size;
+    usage.allocator_overhead +=
+        std::max<size_t>(32, (size + 8 + 15) & ~size_t{15}) - size;
+  };
+
+  std::unordered_set<const Radix_Node *> seen{trie.root()};
+  std::vector<const Radix_Node *> stack{trie.root()};
+  while (!stack.empty()) {
+    const Radix_Node *curr = stack.back();
+    stack.pop_back();
+    usage.node_count++;
+    add(usage.nodes, sizeof(Radix_Node));
+    if (curr->val.capacity() > sso_capacity)
+      add(usage.labels, curr->val.capacity() + 1);
+    if (curr->children.bucket_count() > 1)
+      add(usage.child_containers,
+          curr->children.bucket_count() * sizeof(void *));
+    for (const auto &entry : curr->children) {
+      add(usage.child_containers, entry_size);
+      if (seen.insert(entry.second).second)
+        stack.push_back(entry.second);
+    }
+  }
+  return usage;
+}
+
+static bool counters_match(const Radix_Trie &trie) {
+  Memory_Usage fast = trie.memory_usage();
+  Memory_Usage walked = walk_usage(trie);
+  return fast.nodes == walked.nodes &&
+         fast.child_containers == walked.child_containers &&
+         fast.labels == walked.labels &&
+         fast.allocator_overhead == walked.allocator_overhead &&
+         fast.node_count == walked.node_count;
+}
+
+static std::vector<std::string> random_words(size_t n, uint32_t seed) {
+  return test::random_words(n, seed, test::bytes_of("abcd"), 29,
+                            "a/long/shared/label/");
+}
+
+static void test_insert_and_remove() {
+  Radix_Trie trie;
+  CHECK(counters_match(trie));
+  std::vector<std::string> words = random_words(20000, 1);
+  for (const auto &word : words)
+    trie.insert(word);
+  CHECK(counters_match(trie));
+
+  // Removals free leaves and merge single children into their parents.
+  for (size_t i = 0; i < words.size(); i += 2)
+    trie.remove(words[i]);
+  CHECK(counters_match(trie));
+  for (const auto &word : words)
+    trie.remove(word);
+  CHECK(counters_match(trie));
+  CHECK(trie.memory_usage().node_count == 1);
+}
+
+static void test_bulk_operations() {
+  std::vector<std::string> words = random_words(20000, 2);
+  Radix_Trie trie;
+  for (size_t i = 0; i < 1000; i++)
+    trie.insert(words[i]);
+  trie.insert_parallel(words, 4);
+  CHECK(counters_match(trie));
+
+  radix_trie::test::Temp_Dir dir("memory_usage_test");
+  {
+    std::ofstream os(dir / "words.txt", std::ios::binary);
+    for (const auto &word : random_words(5000, 3))
+      os << word << '\n';
+  }
+  trie.load_lines(dir / "words.txt", 3);
+  CHECK(counters_match(trie));
+  trie.load_lines(dir / "words.txt");
+  CHECK(counters_match(trie));
+
+  std::stringstream base;
+  trie.checkpoint(base);
+  Radix_Trie restored;
+  restored.load(base);
+  CHECK(counters_match(restored));
+
+  for (size_t i = 0; i < words.size(); i += 3)
+    trie.remove(words[i]);
+  for (const auto &word : random_words(500, 4))
+    trie.insert(word);
+  std::stringstream delta;
+  trie.checkpoint_delta(delta);
+  restored.apply_delta(delta);
+  CHECK(counters_match(restored));
+
+  restored.enable_filter();
+  CHECK(restored.memory_usage().filter > 0);
+  CHECK(restored.memory_usage().nodes == walk_usage(restored).nodes);
+}
+
+static void test_freeze() {
+  Radix_Trie trie;
+  for (std::string stem : {"nation", "station", "creation", "relation"})
+    for (std::string suffix : {"", "s", "al", "ally"})
+      trie.insert(stem + suffix);
+  size_t before = trie.memory_usage().node_count;
+  trie.freeze();
+  CHECK(counters_match(trie));
+  CHECK(trie.memory_usage().node_count < before);
+
+  Memory_Usage detailed = trie.memory_usage(true);
+  size_t histogram_nodes = 0;
+  for (size_t count : detailed.fanout)
+    histogram_nodes += count;
+  CHECK(histogram_nodes == detailed.node_count);
+}
+
+int main() {
+  test_insert_and_remove();
+  test_bulk_operations();
+  test_freeze();
+  return radix_trie::test::report();
+}
@@ -0,0 +1,78 @@
+/**
+ * @file        mismatch_test.cpp
+ * @brief       Tests every mismatch() implementation against a byte loop.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#include "check.hpp"
+#include "mismatch.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace radix_trie;
+
+using Mismatch_Fn = size_t (*)(const char *, const char *, size_t);
+
+static size_t mismatch_bytes(const char *a, const char *b, size_t n) {
+  size_t i = 0;
+  while (i < n && a[i] == b[i])
+    i++;
+  return i;
+}
+
+/**
+ * @brief Checks an implementation at lengths up to 80, which cover the
+ * 8, 16 and 32-byte steps and their tails, with no difference and with a
+ * difference at every position, at unaligned addresses.
+ */
+static void check_fn(Mismatch_Fn fn) {
+  std::string a(128, '\0');
+  for (size_t i = 0; i < a.size(); i++)
+    a[i] = static_cast<char>(i * 37 + 11);
+
+  for (size_t offset : {0, 1, 3}) {
+    for (size_t n = 0; n <= 80; n++) {
+      std::string b = a;
+      const char *x = a.data() + offset;
+      CHECK(fn(x, b.data() + offset, n) == n);
+      for (size_t pos = 0; pos < n; pos++) {
+        b = a;
+        // Flip the high bit too, so signed comparisons would go wrong.
+        b[offset + pos] = static_cast<char>(b[offset + pos] ^ 0x81);
+        size_t got = fn(x, b.data() + offset, n);
+        CHECK(got == pos);
+        CHECK(got == mismatch_bytes(x, b.data() + offset, n));
+        // A second difference after the first must not matter.
+        if (pos + 1 < n) {
+          b[offset + n - 1] = static_cast<char>(~b[offset + n - 1]);
+          CHECK(fn(x, b.data() + offset, n) == pos);
+        }
+      }
+    }
+  }
+}
+
+int main() {
+  std::vector<std::pair<const char *, Mismatch_Fn>> fns = {
+      {"mismatch", mismatch}, {"scalar", detail::mismatch_scalar}};
+#ifdef RADIX_TRIE_X86_SIMD
+  fns.emplace_back("sse2", detail::mismatch_sse2);
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    fns.emplace_back("avx2", detail::mismatch_avx2);
+  else
+    std::cerr << "AVX2 not supported, its path is not tested\n";
+#endif
+  for (auto [name, fn] : fns) {
+    int before = radix_trie::test::failures;
+    check_fn(fn);
+    if (radix_trie::test::failures != before)
+      std::cerr << "in " << name << '\n';
+  }
+  return radix_trie::test::report();
+}
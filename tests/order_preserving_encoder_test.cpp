@@ -0,0 +1,126 @@
+/**
+ * @file        order_preserving_encoder_test.cpp
+ * @brief       Tests of the order-preserving encoder and the trie built on
+ *              it.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#include "check.hpp"
+#include "encoded_radix_trie.hpp"
+#include "order_preserving_encoder.hpp"
+
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace radix_trie;
+
+/**
+ * @brief Random keys made of a few frequent words and bytes spread over the
+ * 8-bit range, 0x00 and 0xff included.
+ */
+static std::vector<std::string> random_keys(size_t n, uint32_t seed) {
+  std::vector<std::string> alphabet = {"http://", "www.", "example", ".com/",
+                                       "index",   "ing",  "/"};
+  for (int c = 0; c < 256; c += 51)
+    alphabet.emplace_back(1, static_cast<char>(c));
+  return test::random_words(n, seed, alphabet, 5);
+}
+
+/**
+ * @brief Compares as the encoder does: bytes as unsigned, then by length.
+ */
+static int compare(const std::string &a, const std::string &b) {
+  int c = a.compare(b);
+  return (c > 0) - (c < 0);
+}
+
+static void check_encoder(const Order_Preserving_Encoder &encoder,
+                          const std::vector<std::string> &keys) {
+  std::vector<std::string> codes;
+  for (const std::string &key : keys) {
+    codes.push_back(encoder.encode(key));
+    CHECK(encoder.decode(codes.back()) == key);
+  }
+
+  // Neighbours in sorted order, where a broken order shows first, and
+  // random pairs.
+  std::vector<size_t> order(keys.size());
+  for (size_t i = 0; i < order.size(); i++)
+    order[i] = i;
+  std::ranges::sort(order, {}, [&keys](size_t i) -> const std::string & {
+    return keys[i];
+  });
+  for (size_t i = 1; i < order.size(); i++)
+    CHECK(compare(keys[order[i - 1]], keys[order[i]]) ==
+          compare(codes[order[i - 1]], codes[order[i]]));
+
+  std::mt19937 rng(static_cast<uint32_t>(keys.size()));
+  for (int i = 0; i < 20000; i++) {
+    size_t a = rng() % keys.size();
+    size_t b = rng() % keys.size();
+    CHECK(compare(keys[a], keys[b]) == compare(codes[a], codes[b]));
+  }
+}
+
+static void test_order_and_round_trip() {
+  std::vector<std::string> sample = random_keys(2000, 1);
+  std::vector<std::string> keys = random_keys(3000, 2);
+  keys.insert(keys.end(), {"", std::string(1, '\0'), std::string(2, '\0'),
+                           "\xff", "\xff\xff", "\x7f", "\x80", "www"});
+
+  for (auto [n_grams, max_gram] :
+       {std::pair<size_t, size_t>{0, 2}, {16, 3}, {1024, 4}, {32640, 8}}) {
+    Order_Preserving_Encoder encoder(sample, n_grams, max_gram);
+    check_encoder(encoder, keys);
+    check_encoder(encoder, sample);
+  }
+
+  CHECK_THROWS(Order_Preserving_Encoder(sample, 16, 1), std::invalid_argument);
+  CHECK_THROWS(Order_Preserving_Encoder(sample, 32641), std::invalid_argument);
+}
+
+static void test_encoded_trie() {
+  std::vector<std::string> keys = random_keys(3000, 3);
+  for (auto [n_grams, max_gram] :
+       {std::pair<size_t, size_t>{0, 2}, {64, 4}, {1024, 6}}) {
+    Encoded_Radix_Trie trie(Order_Preserving_Encoder(keys, n_grams, max_gram));
+    std::set<std::string> stored;
+    for (size_t i = 0; i < keys.size(); i++) {
+      if (i % 5 == 4) {
+        CHECK(trie.remove(keys[i]) == (stored.erase(keys[i]) == 1));
+      } else {
+        trie.insert(keys[i]);
+        stored.insert(keys[i]);
+      }
+    }
+
+    for (const std::string &key : random_keys(500, 4))
+      CHECK(trie.contains(key) == stored.contains(key));
+    for (const std::string &pref :
+         std::vector<std::string>{"", "h", "http://", "http://www.ex", "\xff",
+                                  "\xff\xff", std::string(1, '\0'),
+                                  "index/"}) {
+      std::vector<std::string> want;
+      for (auto it = stored.lower_bound(pref);
+           it != stored.end() && it->starts_with(pref); it++)
+        if (it->size() > pref.size())
+          want.push_back(it->substr(pref.size()));
+
+      std::vector<std::string> out;
+      trie.complete(pref, out);
+      CHECK(out == want);
+    }
+  }
+}
+
+int main() {
+  test_order_and_round_trip();
+  test_encoded_trie();
+  return radix_trie::test::report();
+}
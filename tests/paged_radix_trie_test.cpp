@@ -0,0 +1,145 @@
+/**
+ * @file        paged_radix_trie_test.cpp
+ * @brief       Tests of the paged trie writers and the buffer pool reader.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#include "check.hpp"
+#include "paged_radix_trie.hpp"
+
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace radix_trie;
+
+/**
+ * @brief Sorted random keys over a small alphabet, with bytes above 0x7f and
+ * long shared prefixes, so that subtrees span many pages.
+ */
+static std::set<std::string> random_keys(size_t n, uint32_t seed) {
+  std::vector<std::string> keys = test::random_words(
+      n, seed, test::bytes_of("ab/\x80\xff"), 11, "shared/prefix/");
+  return {keys.begin(), keys.end()};
+}
+
+/**
+ * @brief Sorted random keys, each with an extension and a sibling that leaves
+ * it early, so that write_sorted() often splits the label of a node that
+ * already has children and moves them one level down.
+ */
+static std::set<std::string> split_keys(size_t n, uint32_t seed) {
+  const std::string alphabet = "abcd";
+  std::mt19937 rng(seed);
+  std::set<std::string> keys;
+  while (keys.size() < n) {
+    std::string key;
+    for (size_t j = 2 + rng() % 10; j > 0; j--)
+      key += alphabet[rng() % alphabet.size()];
+    keys.insert(key);
+    keys.insert(key + alphabet[rng() % alphabet.size()]);
+    keys.insert(key.substr(0, 1 + rng() % (key.size() - 1)) +
+                alphabet[rng() % alphabet.size()]);
+  }
+  return keys;
+}
+
+/**
+ * @brief Checks that a paged file answers like a set of keys.
+ */
+static void check_matches(const Paged_Radix_Trie &paged,
+                          const std::set<std::string> &keys, uint32_t seed) {
+  for (const std::string &key : keys)
+    CHECK(paged.contains(key));
+
+  for (std::string probe : random_keys(200, seed + 1))
+    CHECK(paged.contains(probe) == keys.contains(probe));
+
+  for (std::string pref : {"", "a", "shared/", "shared/prefix/\x80", "\xff"}) {
+    std::vector<std::string> want;
+    for (auto it = keys.lower_bound(pref);
+         it != keys.end() && it->starts_with(pref); it++)
+      if (it->size() > pref.size())
+        want.push_back(it->substr(pref.size()));
+
+    std::vector<std::string> out;
+    paged.complete(pref, out);
+    CHECK(out == want);
+  }
+}
+
+static void test_writers_agree() {
+  radix_trie::test::Temp_Dir dir("paged_radix_trie_test");
+  for (const std::set<std::string> &keys :
+       {random_keys(20000, 1), split_keys(20000, 2)}) {
+    Radix_Trie trie;
+    for (const std::string &key : keys)
+      trie.insert(key);
+
+    // Small pages hold a few records each, so that a record overrunning its
+    // page is caught.
+    for (size_t page_size : {size_t{83}, size_t{131}, size_t{512},
+                             size_t{4096}}) {
+      for (size_t pin_depth : {1, 2, 3, 4}) {
+        Paged_Radix_Trie::write(trie, dir / "tree.pg", page_size, pin_depth);
+        Paged_Radix_Trie::write_sorted(keys, dir / "sorted.pg", page_size,
+                                       pin_depth);
+
+        Paged_Radix_Trie from_trie(dir / "tree.pg", 4);
+        check_matches(from_trie, keys, 2);
+        Paged_Radix_Trie from_sorted(dir / "sorted.pg", 4);
+        check_matches(from_sorted, keys, 3);
+        CHECK(from_sorted.page_reads() > 0);
+      }
+    }
+  }
+}
+
+static void test_write_sorted_stream() {
+  radix_trie::test::Temp_Dir dir("paged_radix_trie_test");
+  std::set<std::string> keys = {"a", "ab", "abc", "b", "ba", "bb", "c"};
+  std::stringstream lines("a\nab\r\nab\n\nabc\nb\nba\nbb\nc\n");
+  Paged_Radix_Trie::write_sorted(lines, dir / "lines.pg", 64);
+  Paged_Radix_Trie paged(dir / "lines.pg", 1);
+  check_matches(paged, keys, 4);
+  CHECK(!paged.contains(""));
+}
+
+static void test_write_sorted_edge_cases() {
+  radix_trie::test::Temp_Dir dir("paged_radix_trie_test");
+
+  Paged_Radix_Trie::write_sorted(std::vector<std::string>{}, dir / "e.pg");
+  Paged_Radix_Trie empty(dir / "e.pg");
+  CHECK(!empty.contains(""));
+  CHECK(!empty.contains("a"));
+
+  std::set<std::string> keys = {"", "x"};
+  Paged_Radix_Trie::write_sorted(keys, dir / "w.pg", 64, 1);
+  Paged_Radix_Trie with_empty(dir / "w.pg");
+  check_matches(with_empty, keys, 5);
+  CHECK(with_empty.contains(""));
+
+  std::vector<std::string> unsorted = {"b", "a"};
+  CHECK_THROWS(Paged_Radix_Trie::write_sorted(unsorted, dir / "u.pg"),
+               std::invalid_argument);
+  std::vector<std::string> unsigned_order = {"\x7f", "\x80"};
+  Paged_Radix_Trie::write_sorted(unsigned_order, dir / "o.pg", 64);
+  Paged_Radix_Trie ordered(dir / "o.pg");
+  CHECK(ordered.contains("\x7f") && ordered.contains("\x80"));
+  std::vector<std::string> long_label = {std::string(100, 'z')};
+  CHECK_THROWS(
+      Paged_Radix_Trie::write_sorted(long_label, dir / "l.pg", 64, 1),
+      std::invalid_argument);
+}
+
+int main() {
+  test_writers_agree();
+  test_write_sorted_stream();
+  test_write_sorted_edge_cases();
+  return radix_trie::test::report();
+}
@@ -0,0 +1,114 @@
+/**
+ * @file        parallel_insert_test.cpp
+ * @brief       Tests that parallel bulk insertion builds the same trie as
+ *              sequential insertion.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#include "check.hpp"
+#include "radix_trie.hpp"
+
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace radix_trie;
+using radix_trie::test::same_structure;
+
+/**
+ * @brief Keys that nearly all share one long prefix, with duplicates and
+ * keys that are prefixes of other keys, as in URL and tenant key sets.
+ */
+static std::vector<std::string> skewed_keys(size_t n, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < n; i++) {
+    std::string key = rng() % 20 ? "https://www.example.com/" : "ftp://";
+    key += std::to_string(rng() % 50);
+    if (rng() % 3)
+      key += '/' + std::to_string(rng() % 1000);
+    if (rng() % 4 == 0)
+      key += "/index.html";
+    keys.push_back(key);
+  }
+  keys.push_back("https://www.example.com/");
+  keys.push_back("https://www.example.com/");
+  keys.push_back("h");
+  return keys;
+}
+
+static void test_matches_sequential() {
+  std::vector<std::string> keys = skewed_keys(20000, 1);
+  Radix_Trie sequential;
+  for (const auto &key : keys)
+    sequential.insert(key);
+
+  for (size_t n_threads : {1, 2, 3, 8, 32}) {
+    Radix_Trie parallel;
+    parallel.insert_parallel(keys, n_threads);
+    CHECK(same_structure(parallel, sequential));
+  }
+}
+
+static void test_into_existing_trie() {
+  // Existing labels run across the split points of the new words.
+  std::vector<std::string> existing = {"https://www.exa", "https://www.ex/a",
+                                       "https://www.example.com/7/x", "ftp"};
+  std::vector<std::string> keys = skewed_keys(20000, 2);
+
+  Radix_Trie sequential;
+  Radix_Trie parallel;
+  for (const auto &key : existing) {
+    sequential.insert(key);
+    parallel.insert(key);
+  }
+  for (const auto &key : keys)
+    sequential.insert(key);
+  parallel.insert_parallel(keys, 8);
+  CHECK(same_structure(parallel, sequential));
+
+  for (const auto &key : existing)
+    CHECK(parallel.contains(key));
+  CHECK(!parallel.contains("https://www.example.com"));
+}
+
+static void test_parallel_load_lines() {
+  radix_trie::test::Temp_Dir dir("parallel_insert_test");
+  std::vector<std::string> keys = skewed_keys(20000, 3);
+  {
+    std::ofstream os(dir / "keys.txt", std::ios::binary);
+    for (const auto &key : keys)
+      os << key << '\n';
+  }
+
+  Radix_Trie sequential;
+  sequential.load_lines(dir / "keys.txt");
+  Radix_Trie parallel;
+  parallel.load_lines(dir / "keys.txt", 8);
+  CHECK(same_structure(parallel, sequential));
+}
+
+static void test_complete_parallel_order() {
+  Radix_Trie trie;
+  trie.insert_parallel(skewed_keys(20000, 4), 4);
+
+  for (std::string pref : {"", "https://www.example.com/1", "f"}) {
+    std::vector<std::string> expected;
+    trie.complete(pref, expected);
+    std::vector<std::string> out;
+    trie.complete_parallel(pref, out, 8);
+    CHECK(out == expected);
+  }
+}
+
+int main() {
+  test_matches_sequential();
+  test_into_existing_trie();
+  test_parallel_load_lines();
+  test_complete_parallel_order();
+  return radix_trie::test::report();
+}
@@ -0,0 +1,148 @@
+/**
+ * @file        persistence_test.cpp
+ * @brief       Tests of the binary snapshot and delta checkpoint formats.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#include "check.hpp"
+#include "radix_trie.hpp"
+#include "varint.hpp"
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace radix_trie;
+using radix_trie::test::same_structure;
+using namespace std::literals;
+
+/**
+ * @brief Random words over a small alphabet, including the empty word and
+ * bytes above 0x7f, so that many words are prefixes of others.
+ */
+static std::vector<std::string> random_words(size_t n, uint32_t seed) {
+  return test::random_words(n, seed, test::bytes_of("abc\0\xff"sv), 9);
+}
+
+/**
+ * @brief A snapshot header followed by a root node with a given child count.
+ */
+static std::string snapshot_with_child_count(uint64_t count) {
+  std::string data = "RDXT";
+  data += std::string("\x01\x00\x00\x00", 4);
+  put_varint(data, 0);
+  put_varint(data, count << 1);
+  return data;
+}
+
+static void test_round_trip() {
+  Radix_Trie trie;
+  for (const auto &word : random_words(50000, 1))
+    trie.insert(word);
+
+  std::stringstream ss;
+  trie.save(ss);
+  Radix_Trie loaded;
+  loaded.insert("replaced");
+  loaded.load(ss);
+  CHECK(same_structure(loaded, trie));
+  CHECK(!loaded.contains("replaced"));
+
+  radix_trie::test::Temp_Dir dir("persistence_test");
+  trie.save(dir / "trie.bin");
+  Radix_Trie from_file;
+  from_file.load(dir / "trie.bin");
+  CHECK(same_structure(from_file, trie));
+
+  Radix_Trie empty;
+  std::stringstream empty_ss;
+  empty.save(empty_ss);
+  Radix_Trie empty_loaded;
+  empty_loaded.load(empty_ss);
+  CHECK(same_structure(empty_loaded, empty));
+}
+
+static void test_rejects_bad_snapshots() {
+  Radix_Trie trie;
+  for (const auto &word : random_words(1000, 2))
+    trie.insert(word);
+  std::stringstream ss;
+  trie.save(ss);
+  std::string data = ss.str();
+
+  Radix_Trie target;
+  target.insert("kept");
+  for (size_t cut : {size_t{1}, size_t{3}, data.size() / 2}) {
+    std::stringstream truncated(data.substr(0, data.size() - cut));
+    CHECK_THROWS(target.load(truncated), std::runtime_error);
+  }
+  std::stringstream bad_magic("XXXX" + data.substr(4));
+  CHECK_THROWS(target.load(bad_magic), std::runtime_error);
+
+  // A huge child count must be rejected before any table is reserved.
+  std::stringstream huge(snapshot_with_child_count(uint64_t{1} << 40));
+  CHECK_THROWS(target.load(huge), std::runtime_error);
+  std::stringstream too_many(snapshot_with_child_count(257));
+  CHECK_THROWS(target.load(too_many), std::runtime_error);
+
+  CHECK(target.contains("kept"));
+  CHECK(!target.contains("k"));
+}
+
+static void test_delta_chain() {
+  std::mt19937 rng(3);
+  std::vector<std::string> words = random_words(20000, 4);
+  Radix_Trie trie;
+  for (size_t i = 0; i < words.size() / 2; i++)
+    trie.insert(words[i]);
+
+  std::stringstream base;
+  trie.checkpoint(base);
+  std::vector<std::string> deltas;
+  for (int round = 0; round < 5; round++) {
+    for (int i = 0; i < 300; i++) {
+      const std::string &word = words[rng() % words.size()];
+      if (rng() % 2)
+        trie.insert(word);
+      else
+        trie.remove(word);
+    }
+    std::stringstream delta;
+    trie.checkpoint_delta(delta);
+    deltas.push_back(delta.str());
+  }
+
+  Radix_Trie restored;
+  restored.load(base);
+  for (const auto &delta : deltas) {
+    std::stringstream ds(delta);
+    restored.apply_delta(ds);
+  }
+  CHECK(same_structure(restored, trie));
+
+  // A delta taken against another state does not apply.
+  Radix_Trie other;
+  std::stringstream mismatched(deltas[1]);
+  CHECK_THROWS(other.apply_delta(mismatched), std::runtime_error);
+
+  std::string huge = "RDXD";
+  huge += std::string("\x01\x00\x00\x00", 4);
+  huge.push_back(1);
+  put_varint(huge, 0);
+  put_varint(huge, uint64_t{1} << 41);
+  std::stringstream huge_ss(huge);
+  CHECK_THROWS(restored.apply_delta(huge_ss), std::runtime_error);
+  CHECK(same_structure(restored, trie));
+}
+
+int main() {
+  test_round_trip();
+  test_rejects_bad_snapshots();
+  test_delta_chain();
+  return radix_trie::test::report();
+}
@@ -0,0 +1,97 @@
+/**
+ * @file        sharded_radix_trie_test.cpp
+ * @brief       Tests of the sharded trie front-end.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#include "check.hpp"
+#include "sharded_radix_trie.hpp"
+
+#include <format>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace radix_trie;
+using radix_trie::test::bytes_of;
+using radix_trie::test::random_words;
+
+static void test_concurrent_writers() {
+  Sharded_Radix_Trie trie(2);
+  std::vector<std::jthread> writers;
+  for (int k = 0; k < 4; k++)
+    writers.emplace_back([&trie, k] {
+      for (int i = 0; i < 2000; i++)
+        trie.insert(std::format("t{}/{}", k, i));
+    });
+  writers.clear();
+
+  CHECK(trie.contains("t1/55"));
+  CHECK(trie.contains("t3/1999"));
+  CHECK(!trie.contains("t1/"));
+  CHECK(!trie.contains("t1/2000"));
+
+  std::vector<std::string> out;
+  trie.complete("t", out);
+  CHECK(out.size() == 8000);
+  CHECK(trie.remove("t2/7"));
+  CHECK(!trie.remove("t2/7"));
+  CHECK(!trie.contains("t2/7"));
+}
+
+static void test_order_across_shards() {
+  for (size_t prefix_len : {1, 2, 3}) {
+    Sharded_Radix_Trie trie(prefix_len);
+    std::set<std::string> expected;
+    // Bytes on both sides of 0x80, so shards and children collide often and
+    // signed ordering would show.
+    for (const std::string &key :
+         random_words(3000, 7, bytes_of("ab\x7f\x80\xff"), 6, "", 1)) {
+      trie.insert(key);
+      expected.insert(key);
+    }
+
+    std::vector<std::string> words;
+    trie.for_each([&words](std::string_view word) {
+      words.emplace_back(word);
+    });
+    CHECK(words == std::vector<std::string>(expected.begin(), expected.end()));
+
+    for (std::string pref : {"", "a", "\x80", "\xff\x7f", "ab\x80"}) {
+      std::vector<std::string> want;
+      for (auto it = expected.lower_bound(pref);
+           it != expected.end() && it->starts_with(pref); it++)
+        if (it->size() > pref.size())
+          want.push_back(it->substr(pref.size()));
+
+      std::vector<std::string> out;
+      trie.complete(pref, out);
+      CHECK(out == want);
+    }
+  }
+}
+
+static void test_keys_shorter_than_prefix() {
+  Sharded_Radix_Trie trie(3);
+  for (std::string key : {"abc", "ab", "a", "abd", "b"})
+    trie.insert(key);
+
+  CHECK(trie.contains("a"));
+  CHECK(trie.contains("ab"));
+  CHECK(!trie.contains("abcd"));
+
+  std::vector<std::string> out;
+  trie.complete("a", out);
+  CHECK((out == std::vector<std::string>{"b", "bc", "bd"}));
+}
+
+int main() {
+  test_concurrent_writers();
+  test_order_across_shards();
+  test_keys_shorter_than_prefix();
+  return radix_trie::test::report();
+}
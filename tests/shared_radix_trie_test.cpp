@@ -0,0 +1,143 @@
+/**
+ * @file        shared_radix_trie_test.cpp
+ * @brief       Tests of publishing, attaching and refreshing a trie in
+ *              shared memory.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#include "check.hpp"
+#include "shared_radix_trie.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace radix_trie;
+
+/**
+ * @brief Checks whether a shared-memory segment exists.
+ */
+static bool segment_exists(const std::string &name) {
+  int fd = ::shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+  if (fd < 0)
+    return false;
+  ::close(fd);
+  return true;
+}
+
+/**
+ * @brief Returns the permissions of every mapping of a shared-memory
+ * segment in this process, such as "r--s".
+ */
+static std::vector<std::string> mapping_permissions(const std::string &name) {
+  std::vector<std::string> perms;
+  std::ifstream maps("/proc/self/maps");
+  std::string line;
+  while (std::getline(maps, line)) {
+    std::istringstream fields(line);
+    std::string range, perm, offset, dev, inode, path;
+    fields >> range >> perm >> offset >> dev >> inode >> path;
+    if (path == "/dev/shm" + name)
+      perms.push_back(perm);
+  }
+  return perms;
+}
+
+static void test_generations() {
+  const std::string name =
+      "/radix_trie_shared_test." + std::to_string(::getpid());
+  Shared_Radix_Trie::unlink(name);
+  CHECK_THROWS(Shared_Radix_Trie{name}, std::system_error);
+
+  Radix_Trie first;
+  for (std::string word : {"alpha", "alpine", "beta"})
+    first.insert(word);
+  Shared_Radix_Trie::publish(name, first);
+
+  Shared_Radix_Trie reader(name);
+  CHECK(reader.generation() == 1);
+  CHECK(!reader.is_stale());
+  CHECK(!reader.refresh());
+  CHECK(reader.trie().contains("alpine"));
+  CHECK(!reader.trie().contains("gamma"));
+  std::vector<std::string> out;
+  reader.trie().complete("alp", out);
+  CHECK((out == std::vector<std::string>{"ha", "ine"}));
+
+  // Another process attaches to the same segments.
+  pid_t pid = ::fork();
+  if (pid == 0) {
+    Shared_Radix_Trie child(name);
+    ::_exit(child.generation() == 1 && child.trie().contains("beta") ? 0 : 1);
+  }
+  int status = 0;
+  CHECK(::waitpid(pid, &status, 0) == pid);
+  CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+  // A new generation leaves the attached one readable until refresh().
+  Radix_Trie second;
+  for (std::string word : {"beta", "gamma"})
+    second.insert(word);
+  Shared_Radix_Trie::publish(name, second);
+  CHECK(!segment_exists(name + ".1"));
+  CHECK(reader.is_stale());
+  CHECK(reader.trie().contains("alpha"));
+  CHECK(!reader.trie().contains("gamma"));
+
+  CHECK(reader.refresh());
+  CHECK(reader.generation() == 2);
+  CHECK(!reader.is_stale());
+  CHECK(!reader.refresh());
+  CHECK(!reader.trie().contains("alpha"));
+  CHECK(reader.trie().contains("gamma"));
+
+  Shared_Radix_Trie late(name);
+  CHECK(late.generation() == 2);
+
+  // Unlinking removes both segments; mapped readers keep working.
+  Shared_Radix_Trie::unlink(name);
+  CHECK(!segment_exists(name));
+  CHECK(!segment_exists(name + ".2"));
+  CHECK(reader.trie().contains("gamma"));
+  CHECK_THROWS(Shared_Radix_Trie{name}, std::system_error);
+  Shared_Radix_Trie::unlink(name);
+}
+
+static void test_read_only_readers() {
+  const std::string name =
+      "/radix_trie_shared_ro_test." + std::to_string(::getpid());
+  Shared_Radix_Trie::unlink(name);
+  Radix_Trie trie;
+  trie.insert("alpha");
+  Shared_Radix_Trie::publish(name, trie);
+
+  // Readers only need read access to the control segment, and map it
+  // read-only, so they cannot change the generation.
+  int fd = ::shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+  CHECK(fd >= 0 && ::fchmod(fd, 0444) == 0);
+  ::close(fd);
+  {
+    Shared_Radix_Trie reader(name);
+    CHECK(reader.trie().contains("alpha"));
+    std::vector<std::string> perms = mapping_permissions(name);
+    CHECK(perms == std::vector<std::string>{"r--s"});
+  }
+  Shared_Radix_Trie::unlink(name);
+}
+
+int main() {
+  test_generations();
+  test_read_only_readers();
+  return radix_trie::test::report();
+}
@@ -0,0 +1,95 @@
+/**
+ * @file        span_trie_test.cpp
+ * @brief       Tests of the span trie at every digit width against std::set.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#include "check.hpp"
+#include "span_trie.hpp"
+
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace radix_trie;
+
+/**
+ * @brief Short random keys over bytes that differ in few bits, 0x00 and 0xff
+ * among them, so the keys share many leading digits at every span.
+ */
+static std::string random_key(std::mt19937 &rng) {
+  const std::string alphabet("\x00\x01\x7f\x80\xfe\xff" "a", 7);
+  std::string key;
+  for (size_t i = rng() % 6; i > 0; i--)
+    key += alphabet[rng() % alphabet.size()];
+  return key;
+}
+
+static std::vector<std::string> expected_completions(
+    const std::set<std::string> &keys, const std::string &pref) {
+  std::vector<std::string> want;
+  for (auto it = keys.lower_bound(pref);
+       it != keys.end() && it->starts_with(pref); it++)
+    if (it->size() > pref.size())
+      want.push_back(it->substr(pref.size()));
+  return want;
+}
+
+template <unsigned Span> static void test_against_set(uint32_t seed) {
+  std::mt19937 rng(seed);
+  Span_Trie<Span> trie;
+  std::set<std::string> keys;
+
+  CHECK(!trie.contains(""));
+  CHECK(!trie.remove(""));
+  for (int step = 0; step < 5000; step++) {
+    std::string key = random_key(rng);
+    switch (rng() % 4) {
+    case 0:
+    case 1:
+      CHECK(trie.insert(key) == keys.insert(key).second);
+      break;
+    case 2:
+      CHECK(trie.remove(key) == (keys.erase(key) == 1));
+      break;
+    default: {
+      CHECK(trie.contains(key) == keys.contains(key));
+      std::vector<std::string> out;
+      trie.complete(key, out);
+      CHECK(out == expected_completions(keys, key));
+    }
+    }
+    CHECK(trie.size() == keys.size());
+  }
+
+  for (const std::string &key : keys)
+    CHECK(trie.contains(key));
+  std::vector<std::string> out;
+  trie.complete("", out);
+  CHECK(out == expected_completions(keys, ""));
+
+  // Empty the trie, then refill it through the empty key.
+  for (const std::string &key : std::set<std::string>(keys))
+    CHECK(trie.remove(key));
+  CHECK(trie.size() == 0);
+  CHECK(trie.insert(""));
+  CHECK(trie.contains(""));
+  CHECK(trie.insert(std::string(1, '\0')));
+  CHECK(!trie.contains(std::string(2, '\0')));
+  CHECK(trie.remove(""));
+  CHECK(trie.contains(std::string(1, '\0')));
+}
+
+int main() {
+  for (uint32_t seed = 1; seed <= 3; seed++) {
+    test_against_set<1>(seed);
+    test_against_set<2>(seed);
+    test_against_set<4>(seed);
+    test_against_set<8>(seed);
+  }
+  return radix_trie::test::report();
+}
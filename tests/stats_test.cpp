@@ -0,0 +1,78 @@
+/**
+ * @file        stats_test.cpp
+ * @brief       Tests of the structural statistics on small known tries.
+ *
+ * @author      Arsenii Kvachan
+ * @date        2026-10-16
+ * @copyright   MIT License (see LICENSE file for details)
+ */
+
+#include "check.hpp"
+#include "radix_trie.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace radix_trie;
+
+static void test_empty() {
+  Radix_Trie trie;
+  Trie_Stats stats = trie.stats();
+  CHECK(stats.node_count == 1);
+  CHECK(stats.word_count == 0);
+  CHECK(stats.max_depth == 0);
+  CHECK(stats.average_depth == 0);
+  CHECK(stats.single_child_share == 0);
+  CHECK(stats.longest_chain == 0);
+  CHECK((stats.fanout == std::vector<size_t>{1}));
+  CHECK((stats.label_lengths == std::vector<size_t>{1}));
+}
+
+static void test_known_trie() {
+  // ""
+  // ├── a ─ b ─ c ─ d
+  // └── x ─ y ─ lophone
+  Radix_Trie trie;
+  for (std::string word : {"a", "ab", "abc", "abcd", "x", "xy", "xylophone"})
+    trie.insert(word);
+
+  Trie_Stats stats = trie.stats();
+  CHECK(stats.node_count == 8);
+  CHECK(stats.word_count == 7);
+  CHECK(stats.max_depth == 4);
+  CHECK(stats.average_depth == 16.0 / 7);
+  CHECK(stats.single_child_share == 5.0 / 8);
+  CHECK(stats.longest_chain == 3);
+  CHECK((stats.fanout == std::vector<size_t>{2, 5, 1}));
+  CHECK((stats.label_lengths == std::vector<size_t>{1, 6, 0, 1}));
+
+  // Removing "abc" merges "c" and "d" into one label of two bytes.
+  trie.remove("abc");
+  stats = trie.stats();
+  CHECK(stats.node_count == 7);
+  CHECK(stats.word_count == 6);
+  CHECK(stats.max_depth == 3);
+  CHECK(stats.longest_chain == 2);
+  CHECK((stats.label_lengths == std::vector<size_t>{1, 4, 1, 1}));
+}
+
+static void test_frozen_counts_paths() {
+  Radix_Trie trie;
+  for (std::string word : {"nation", "nations", "station", "stations"})
+    trie.insert(word);
+  Trie_Stats before = trie.stats();
+  trie.freeze();
+  Trie_Stats after = trie.stats();
+  CHECK(after.node_count == before.node_count);
+  CHECK(after.word_count == before.word_count);
+  CHECK(after.max_depth == before.max_depth);
+  CHECK(after.fanout == before.fanout);
+  CHECK(after.label_lengths == before.label_lengths);
+}
+
+int main() {
+  test_empty();
+  test_known_trie();
+  test_frozen_counts_paths();
+  return radix_trie::test::report();
+}